@@ -0,0 +1,140 @@
+// NULL TERMINATOR — sprite atlas
+
+#include "atlas.h"
+#include "sim.h"
+#include "mem.h"
+#include <math.h>
+
+#define ATLAS_W 512
+#define ATLAS_H 64
+#define ATLAS_PAD 2           // texels between cells, so filtering doesn't bleed
+
+// where the sprite being baked sits in the atlas image
+typedef struct {
+    Image *img;
+    float x, y;               // cell origin, texels
+} Cell;
+
+static Vector2 Px(const Cell *c, float x, float y) {
+    return (Vector2){ c->x + x * ATLAS_SCALE, c->y + y * ATLAS_SCALE };
+}
+
+static void Disc(const Cell *c, float x, float y, float r, Color col) {
+    ImageDrawCircleV(c->img, Px(c, x, y), (int)lroundf(r * ATLAS_SCALE), col);
+}
+
+static void Tri(const Cell *c, Vector2 a, Vector2 b, Vector2 d, Color col) {
+    ImageDrawTriangle(c->img, Px(c, a.x, a.y), Px(c, b.x, b.y), Px(c, d.x, d.y), col);
+}
+
+// thick line as two triangles
+static void Line(const Cell *c, Vector2 a, Vector2 b, float thick, Color col) {
+    float dx = b.x - a.x, dy = b.y - a.y;
+    float len = sqrtf(dx*dx + dy*dy);
+    if (len < 0.0001f) return;
+    float nx = -dy / len * thick * 0.5f, ny = dx / len * thick * 0.5f;
+    Vector2 p0 = { a.x + nx, a.y + ny }, p1 = { a.x - nx, a.y - ny };
+    Vector2 p2 = { b.x - nx, b.y - ny }, p3 = { b.x + nx, b.y + ny };
+    Tri(c, p0, p1, p2, col);
+    Tri(c, p0, p2, p3, col);
+}
+
+// Filled heart: two lobes + wide body triangle + small V-notch at top.
+// (same shape the HUD used to draw live every frame)
+static void BakeHeart(const Cell *c, Vector2 p, float s, bool cracked) {
+    // Tweakable proportions that read well at small sizes (16–24px)
+    float r   = s * 0.34f;                 // lobe radius
+    float lift= s * 0.08f;                 // raise the seam slightly
+    float body= s * 0.95f;                 // bottom point depth
+
+    // Merge lobes
+    Disc(c, p.x - r, p.y - lift, r, WHITE);
+    Disc(c, p.x + r, p.y - lift, r, WHITE);
+
+    // Body triangle (wider than lobe distance so sides look rounded)
+    Tri(c, (Vector2){ p.x - 2.15f*r, p.y }, (Vector2){ p.x + 2.15f*r, p.y }, (Vector2){ p.x, p.y + body }, WHITE);
+
+    // Carve a small V-notch (triangle) so it reads as a heart, not a blob
+    Tri(c, (Vector2){ p.x, p.y - r*0.25f }, (Vector2){ p.x - r*0.70f, p.y + r*0.10f },
+        (Vector2){ p.x + r*0.70f, p.y + r*0.10f }, BLACK);
+
+    // Thin zig-zag crack that stays readable at small sizes.
+    if (cracked) {
+        Vector2 a = { p.x,           p.y - s*0.06f };
+        Vector2 b = { p.x - s*0.16f, p.y + s*0.22f };
+        Vector2 d = { p.x + s*0.10f, p.y + s*0.52f };
+        Line(c, a, b, 2.0f, BLACK);
+        Line(c, b, d, 2.0f, BLACK);
+    }
+}
+
+static void BakeCrosshair(const Cell *c, Vector2 p) {
+    const float arm = 8;
+    const float gap = 4;
+    Line(c, (Vector2){ p.x - (gap+arm), p.y }, (Vector2){ p.x - gap, p.y }, 2.0f, WHITE);
+    Line(c, (Vector2){ p.x + gap, p.y }, (Vector2){ p.x + (gap+arm), p.y }, 2.0f, WHITE);
+    Line(c, (Vector2){ p.x, p.y - (gap+arm) }, (Vector2){ p.x, p.y - gap }, 2.0f, WHITE);
+    Line(c, (Vector2){ p.x, p.y + gap }, (Vector2){ p.x, p.y + (gap+arm) }, 2.0f, WHITE);
+    Disc(c, p.x, p.y, 1.5f, WHITE);
+}
+
+// ring, or all black on the blink frames (it still hides what's under it)
+static void BakePlayer(const Cell *c, Vector2 p, Color outer) {
+    Disc(c, p.x, p.y, PLAYER_RADIUS, outer);
+    Disc(c, p.x, p.y, PLAYER_RADIUS - 2, BLACK);
+}
+
+Atlas AtlasBuild(void) {
+    Atlas a = {0};
+    Image img = GenImageColor(ATLAS_W, ATLAS_H, BLANK);
+
+    // one row of cells, each `size` pixels square on screen
+    const struct { SpriteId id; float size; } cells[SPR_COUNT] = {
+        { SPR_CIRCLE,        32 }, { SPR_ENEMY,       2 * ENEMY_RADIUS + 4 },
+        { SPR_HEART_FULL,    32 }, { SPR_HEART_CRACKED, 32 },
+        { SPR_CROSSHAIR,     32 }, { SPR_PLAYER,      2 * PLAYER_RADIUS + 4 },
+        { SPR_PLAYER_HURT,   2 * PLAYER_RADIUS + 4 },
+    };
+
+    float x = 0;
+    for (int i = 0; i < SPR_COUNT; ++i) {
+        float size = cells[i].size;
+        Cell c = { &img, x, 0 };
+        Vector2 mid = { size * 0.5f, size * 0.5f };
+        Sprite *s = &a.sprites[cells[i].id];
+        s->src = (Rectangle){ x, 0, size * ATLAS_SCALE, size * ATLAS_SCALE };
+        s->size = (Vector2){ size, size };
+        s->anchor = mid;
+
+        switch (cells[i].id) {
+            // disc fills the cell minus a texel
+            case SPR_CIRCLE:        s->radius = mid.x - 1.0f / ATLAS_SCALE; Disc(&c, mid.x, mid.y, s->radius, WHITE); break;
+            case SPR_ENEMY:         s->radius = ENEMY_RADIUS; Disc(&c, mid.x, mid.y, s->radius, WHITE); break;
+            case SPR_HEART_FULL:    s->anchor.y = 10; BakeHeart(&c, s->anchor, HEART_SIZE, false); break;
+            case SPR_HEART_CRACKED: s->anchor.y = 10; BakeHeart(&c, s->anchor, HEART_SIZE, true); break;
+            case SPR_CROSSHAIR:     BakeCrosshair(&c, mid); break;
+            case SPR_PLAYER:        BakePlayer(&c, mid, WHITE); break;
+            case SPR_PLAYER_HURT:   BakePlayer(&c, mid, BLACK); break;
+            default: break;
+        }
+        x += size * ATLAS_SCALE + ATLAS_PAD;
+    }
+
+    a.tex = LoadTextureFromImage(img);
+    UnloadImage(img);
+    if (a.tex.id) MemNoteHeld(MEM_RENDER, (int64_t)a.tex.width * a.tex.height * 4);   // VRAM, rgba8
+    SetTextureFilter(a.tex, TEXTURE_FILTER_BILINEAR);
+    return a;
+}
+
+void AtlasUnload(Atlas *a) {
+    if (a->tex.id) MemNoteHeld(MEM_RENDER, -(int64_t)a->tex.width * a->tex.height * 4);
+    UnloadTexture(a->tex);
+    a->tex = (Texture2D){0};
+}
+
+void AtlasDraw(const Atlas *a, SpriteId id, Vector2 pos) {
+    const Sprite *s = &a->sprites[id];
+    Rectangle dst = { pos.x - s->anchor.x, pos.y - s->anchor.y, s->size.x, s->size.y };
+    DrawTexturePro(a->tex, s->src, dst, (Vector2){ 0, 0 }, 0.0f, WHITE);
+}
@@ -0,0 +1,47 @@
+// NULL TERMINATOR — sprite atlas
+// Every little shape the game draws over and over (hearts, crosshair, player, enemies,
+// the generic circle) baked once at startup into one texture with the Image API.
+// Drawing any of them is then a single textured quad, and since they all share the
+// texture, raylib keeps them in the same batch.
+
+#ifndef NT_ATLAS_H
+#define NT_ATLAS_H
+
+#include "raylib.h"
+
+#define HEART_SIZE 18.0f      // logical size for drawing
+
+// sprites are rasterized at this multiple of their on-screen size and filtered down
+#define ATLAS_SCALE 2
+
+typedef enum {
+    SPR_CIRCLE = 0,          // plain white disc, stretched to any radius (bullets, flashes)
+    SPR_ENEMY,
+    SPR_HEART_FULL,
+    SPR_HEART_CRACKED,
+    SPR_CROSSHAIR,
+    SPR_PLAYER,
+    SPR_PLAYER_HURT,         // hurt-blink frame
+    SPR_COUNT
+} SpriteId;
+
+typedef struct {
+    Rectangle src;           // texels in the atlas
+    Vector2 size;            // on-screen size, pixels
+    Vector2 anchor;          // the point that goes at the draw position, pixels from the top left
+    float radius;            // circle sprites: radius of the baked disc (to scale it to any size)
+} Sprite;
+
+typedef struct {
+    Texture2D tex;
+    Sprite sprites[SPR_COUNT];
+} Atlas;
+
+// needs a window (uploads the texture)
+Atlas AtlasBuild(void);
+void AtlasUnload(Atlas *a);
+
+// sprite at its baked size with its anchor on pos
+void AtlasDraw(const Atlas *a, SpriteId id, Vector2 pos);
+
+#endif
@@ -1,10 +1,29 @@
 // NULL TERMINATOR — Controls Sandbox (C + raylib)
 // Aim with mouse/trackpad, custom crosshair, click to "fire".
-// mac build: gcc controls_sandbox.c -o null_controls -O2 -Wall -std=c99 -lraylib -lm
+// Game rules live in src/sim.c, this file is just window, input and drawing.
+// mac build: make (or gcc controls_sandbox.c src/*.c -Isrc -o null_controls -O2 -Wall -std=c99 -lraylib -lm)
 
 #include "raylib.h" // library for game functions
-#include <math.h>   
-#include <stdio.h> 
+#include "rlgl.h"   // batched quads for the render lists
+#include "sim.h"
+#include "rng.h"
+#include "jobs.h"
+#include "mem.h"
+#include "prof.h"
+#include "render.h"
+#include "particles.h"
+#include "atlas.h"
+#include "hud.h"
+#include "replay.h"
+#include "scores.h"
+#include "snapshot.h"
+#include "net.h"
+#include "telemetry.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 
 // top level
@@ -18,9 +37,11 @@ static float EaseBanner(float a) {
 }
 
 
-// high score
-static const char *HS_FILE = "highscore.txt";
-static int LoadHighScore(const char *path) {
+// high scores: binary top-10 in SCORES_FILE, saved by the writer thread (src/scores.h)
+static const char *SCORES_FILE = "highscore.dat";
+static const char *LEGACY_HS_FILE = "highscore.txt";   // the old single number, read once to migrate
+
+static int LoadLegacyHighScore(const char *path) {
     int hs = 0;
     FILE *f = fopen(path, "r");
     if (f) {
@@ -30,587 +51,425 @@ static int LoadHighScore(const char *path) {
     return hs;
 }
 
-static void SaveHighScore(const char *path, int hs) {
-    FILE *f = fopen(path, "w");
-    if (f) {
-        fprintf(f, "%d\n", hs);
-        fclose(f);
-    }
-}
-
-// screen
-#define SCREEN_W 960
-#define SCREEN_H 540
-
-// starter pistol
-#define FIRE_RATE 6.0f 
-#define TRACE_LIFE 0.12f
-
-// starter pistol bullets
-#define BULLET_SPEED 540.0f // pixels per second
-#define BULLET_LIFETIME 0.6f // bullet on screen time
-#define BULLET_RADIUS 3.0f // how big it is
-#define MAX_BULLETS 256 
-
-// #define ENEMY_SPEED 85.0f // pixels/sec
-#define ENEMY_RADIUS 8.0f
-#define MAX_ENEMIES 256
-#define ENEMY_SPAWN_INTERVAL 1.0f // spawn one per sec (fix later)
-
-#define PLAYER_RADIUS 10.0f   // was hardcoded in draw; now a constant
-#define HP_MAX 6              // 3 hearts × 2 hits each
-#define HEARTS 3
-#define HIT_IFRAME 0.8f       // seconds of invulnerability after a hit
-
-// hearts UI layout
-#define HEART_SIZE 18.0f      // logical size for drawing
-#define HEART_GAP  10         // pixels between hearts
-
-// dificulty ramp (time based)
-#define SPAWN_BASE 1.00f // seconds between spawns at t=0
-#define SPAWN_MIN 0.20f // fastest allowed (for now heeheehee)
-#define SPAWN_RAMP 0.015f // how much to subract per second on linear approach
-
-// difficulty ramper
-#define ENEMY_SPEED_BASE 85.0f // starting speed, was ENEMY_SPEED
-#define ENEMY_SPEED_MAX 220.f // limit, no cap aye
-#define ENEMY_SPEED_RAMP 0.60f // +speed per second, 36 per minute bruh
-
-// shotgun stats
-#define SHOTGUN_UNLOCK_AFTER_SCORE 500
-#define SHOTGUN_PELLETS 5
-#define SHOTGUN_SPREAD_DEG 18.0f // around 18 degreees spread each slide
-#define SHOTGUN_FIRE_RATE 2.8f
-
-
-
-// struct to store shot effect (start point, end point and time to live)
-typedef struct {
-    Vector2 a, b;     // line from A (player) to B (impact point = cursor)
-    float   life;     // remaining lifetime (seconds)
-} ShotTrace;
-
-
-typedef struct {
-    Vector2 pos;
-    Vector2 vel;
-    float life;
-    int alive;
-} Bullet;
-
-typedef struct {
-    Vector2 pos;
-    Vector2 vel;
-    int alive;
-} Enemy;
-
-typedef enum { STATE_PLAYING = 0, STATE_GAME_OVER = 1 } GameState;
-
-static Enemy enemies[MAX_ENEMIES];
-static int enemyCount = 0;
-
-static Bullet bullets[MAX_BULLETS];
-static int bulletCount = 0;
-
-#define MAX_TRACES 128
-
-static ShotTrace traces[MAX_TRACES];  
-static int traceCount = 0;            // how many are alive in array
-
-
-// helper function to add traces
-// helper function to add traces
-static void AddTrace(Vector2 a, Vector2 b) {
-    if (traceCount >= MAX_TRACES) return;
-    traces[traceCount++] = (ShotTrace){ a, b, TRACE_LIFE };  // short-lived flash
-}
-
 
-// helper to update and remove expired traces
-static void UpdateTraces(float dt) {
-    for (int i = traceCount - 1; i >= 0; --i) {
-        traces[i].life -= dt;
-        if (traces[i].life <= 0.0f) {
-            // remove by swap
-            traces[i] = traces[traceCount - 1];
-            traceCount--;
+// sim works in its own Vec2, same layout as raylib's
+static Vector2 V(Vec2 v) { return (Vector2){ v.x, v.y }; }
+
+// one textured quad per circle, using a circle sprite from the atlas; flushing after
+// every RENDER_BATCH_QUADS keeps it at exactly RenderDrawCalls() draw calls
+static void SubmitCircles(const RenderGroup *g, const Atlas *atlas, SpriteId id) {
+    const Sprite *spr = &atlas->sprites[id];
+    const float scale = spr->size.x * 0.5f / spr->radius;    // quad half-size per unit of radius
+    float u0 = spr->src.x / atlas->tex.width, u1 = (spr->src.x + spr->src.width) / atlas->tex.width;
+    float v0 = spr->src.y / atlas->tex.height, v1 = (spr->src.y + spr->src.height) / atlas->tex.height;
+    for (int start = 0; start < g->count; start += RENDER_BATCH_QUADS) {
+        int end = start + RENDER_BATCH_QUADS < g->count ? start + RENDER_BATCH_QUADS : g->count;
+        rlSetTexture(atlas->tex.id);
+        rlBegin(RL_QUADS);
+        rlColor4ub(255, 255, 255, 255);
+        for (int i = start; i < end; ++i) {
+            const RenderCmd *c = &g->cmds[i];
+            float h = c->size * scale;
+            rlTexCoord2f(u0, v0); rlVertex2f(c->x0 - h, c->y0 - h);
+            rlTexCoord2f(u0, v1); rlVertex2f(c->x0 - h, c->y0 + h);
+            rlTexCoord2f(u1, v1); rlVertex2f(c->x0 + h, c->y0 + h);
+            rlTexCoord2f(u1, v0); rlVertex2f(c->x0 + h, c->y0 - h);
         }
+        rlEnd();
+        rlSetTexture(0);
+        rlDrawRenderBatchActive();
     }
 }
 
-static void AddBullet(Vector2 from, Vector2 to) {
-    if (bulletCount >= MAX_BULLETS) return;
-
-    // direction = normalized (to > from)
-    Vector2 dir = { to.x - from.x, to.y - from.y };
-    float len = sqrtf(dir.x*dir.x + dir.y*dir.y);
-    if (len <= 0.0001f) return;
-    dir.x /= len; dir.y /= len;
-
-    bullets[bulletCount++] = (Bullet) {
-        .pos = from,
-        .vel = (Vector2){ dir.x * BULLET_SPEED, dir.y * BULLET_SPEED },
-        .life = BULLET_LIFETIME,
-        .alive = 1
-    };
-}
-
-static void UpdateBullets(float dt) {
-    for (int i = bulletCount - 1; i>= 0; --i) {
-        Bullet *b = &bullets[i];
-        if (!b->alive) continue;
-
-        b->pos.x += b->vel.x * dt;
-        b->pos.y += b->vel.y * dt;
-        b->life   -= dt;
-
-        // kill if expired or off-screen
-        if (b->life <= 0.0f ||
-            b->pos.x < -20 || b->pos.x > SCREEN_W + 20 ||
-            b->pos.y < -20 || b->pos.y > SCREEN_H + 20) {
-                bullets[i] = bullets[bulletCount - 1];
-                bulletCount--;
+// thick lines as untextured quads (rlgl's 1x1 white default texture)
+static void SubmitLines(const RenderGroup *g) {
+    for (int start = 0; start < g->count; start += RENDER_BATCH_QUADS) {
+        int end = start + RENDER_BATCH_QUADS < g->count ? start + RENDER_BATCH_QUADS : g->count;
+        rlSetTexture(rlGetTextureIdDefault());
+        rlBegin(RL_QUADS);
+        rlColor4ub(255, 255, 255, 255);
+        for (int i = start; i < end; ++i) {
+            const RenderCmd *c = &g->cmds[i];
+            float dx = c->x1 - c->x0, dy = c->y1 - c->y0;
+            float len = sqrtf(dx*dx + dy*dy);
+            if (len < 0.0001f) continue;
+            float nx = -dy / len * c->size * 0.5f, ny = dx / len * c->size * 0.5f;
+            rlTexCoord2f(0.0f, 0.0f); rlVertex2f(c->x0 + nx, c->y0 + ny);
+            rlTexCoord2f(0.0f, 1.0f); rlVertex2f(c->x0 - nx, c->y0 - ny);
+            rlTexCoord2f(1.0f, 1.0f); rlVertex2f(c->x1 - nx, c->y1 - ny);
+            rlTexCoord2f(1.0f, 0.0f); rlVertex2f(c->x1 + nx, c->y1 + ny);
         }
+        rlEnd();
+        rlSetTexture(0);
+        rlDrawRenderBatchActive();
     }
 }
 
-static void DrawCrosshair(Vector2 p) {
-    const int arm = 8;
-    const int gap = 4;
-    DrawLineEx((Vector2){p.x - (gap+arm), p.y}, (Vector2){p.x - gap, p.y}, 2.0f, WHITE);
-    DrawLineEx((Vector2){p.x + gap, p.y}, (Vector2){p.x + (gap+arm), p.y}, 2.0f, WHITE);
-    DrawLineEx((Vector2){p.x, p.y - (gap+arm)}, (Vector2){p.x, p.y - gap}, 2.0f, WHITE);
-    DrawLineEx((Vector2){p.x, p.y + gap}, (Vector2){p.x, p.y + (gap+arm)}, 2.0f, WHITE);
-    DrawCircleV(p, 1.5f, WHITE);
-}
-
-static void AddEnemy(Vector2 player, float speed) {
-    if (enemyCount >= MAX_ENEMIES) return;
-
-    int side = GetRandomValue(0, 3);
-    Vector2 p = {0};
 
-    switch (side) {
-        case 0: p.x = -10;               p.y = GetRandomValue(0, SCREEN_H); break;
-        case 1: p.x = SCREEN_W + 10;     p.y = GetRandomValue(0, SCREEN_H); break;
-        case 2: p.x = GetRandomValue(0, SCREEN_W); p.y = -10;               break;
-        case 3: p.x = GetRandomValue(0, SCREEN_W); p.y = SCREEN_H + 10;     break;
+// F3 overlay: p50/p99 per phase, top left under the HUD text
+static void DrawProfiler(const ProfStats *st, int hudRedraws) {
+    int x = 16, y = 60, line = 14;
+    DrawRectangle(x - 6, y - 6, 300, line * (PROF_PHASE_COUNT + 3) + 8, Fade(BLACK, 0.7f));
+    DrawText(TextFormat("hud layer redraws: %d", hudRedraws), x, y + line * (PROF_PHASE_COUNT + 2), 10, WHITE);
+    if (!PROF_ENABLED) {
+        DrawText("profiler compiled out (make PROFILE=1)", x, y, 10, WHITE);
+        return;
     }
-
-    Vector2 dir = (Vector2){ player.x - p.x, player.y - p.y };
-    float len = sqrtf(dir.x*dir.x + dir.y*dir.y);
-    if (len < 0.0001f) len = 0.0001f;
-    dir.x /= len; dir.y /= len;
-
-    enemies[enemyCount++] = (Enemy){
-        .pos = p,
-        .vel = (Vector2){ dir.x * speed, dir.y * speed },  
-        .alive = 1
-    };
-}
-
-
-static void UpdateEnemies(float dt) {
-    for (int i = enemyCount - 1; i >= 0; --i) {
-        Enemy *e = &enemies[i];
-        if (!e->alive) continue;
-
-        e->pos.x += e->vel.x * dt;
-        e->pos.y += e->vel.y * dt;
-
-        if (e->pos.x < -50 || e->pos.x > SCREEN_W + 50 ||
-            e->pos.y < -50 || e->pos.y > SCREEN_H + 50) {
-            enemies[i] = enemies[enemyCount - 1];
-            enemyCount--;
-        }
+    DrawText("phase                p50 us    p99 us   (F4 dump)", x, y, 10, WHITE);
+    for (int p = 0; p < PROF_PHASE_COUNT; ++p) {
+        y += line;
+        DrawText(ProfPhaseName((ProfPhase)p), x, y, 10, WHITE);
+        if (st[p].count == 0) continue;
+        DrawText(TextFormat("%8.1f  %8.1f", st[p].p50, st[p].p99), x + 150, y, 10, WHITE);
     }
 }
 
-static float Dist2(Vector2 a, Vector2 b) {
-    float dx = a.x - b.x, dy = a.y - b.y;
-    return dx*dx + dy*dy;
-}
-
-// HEARTS / FIX LATER
-
-// Filled heart: two lobes + wide body triangle + small V-notch at top.
-static void DrawHeartFilled(Vector2 p, float s) {
-    // Tweakable proportions that read well at small sizes (16–24px)
-    float r   = s * 0.34f;                 // lobe radius
-    float lift= s * 0.08f;                 // raise the seam slightly
-    float body= s * 0.95f;                 // bottom point depth
-
-    // Lobe centers slightly above centerline
-    Vector2 left   = (Vector2){ p.x - r, p.y - lift };
-    Vector2 right  = (Vector2){ p.x + r, p.y - lift };
-    Vector2 bottom = (Vector2){ p.x,     p.y + body };
-
-    // Merge lobes
-    DrawCircleV(left,  r, WHITE);
-    DrawCircleV(right, r, WHITE);
-
-    // Body triangle (wider than lobe distance so sides look rounded)
-    Vector2 tl = (Vector2){ p.x - 2.15f*r, p.y };
-    Vector2 tr = (Vector2){ p.x + 2.15f*r, p.y };
-    DrawTriangle(tl, tr, bottom, WHITE);
-
-    // Carve a small V-notch (triangle) so it reads as a heart, not a blob
-    Vector2 vA = (Vector2){ p.x,            p.y - r*0.25f };
-    Vector2 vB = (Vector2){ p.x - r*0.70f,  p.y + r*0.10f };
-    Vector2 vC = (Vector2){ p.x + r*0.70f,  p.y + r*0.10f };
-    DrawTriangle(vA, vB, vC, BLACK);
-}
-
-// Thin zig-zag crack that stays readable at small sizes.
-static void DrawHeartCrack(Vector2 p, float s) {
-    Vector2 a = (Vector2){ p.x,            p.y - s*0.06f };
-    Vector2 b = (Vector2){ p.x - s*0.16f,  p.y + s*0.22f };
-    Vector2 c = (Vector2){ p.x + s*0.10f,  p.y + s*0.52f };
-    DrawLineEx(a, b, 2.0f, BLACK);
-    DrawLineEx(b, c, 2.0f, BLACK);
-}
-
-// state: 0=full, 1=cracked (show crack), 2=broken (draw nothing)
-static void DrawHeartIcon(Vector2 p, float s, int state) {
-    if (state == 2) return;     // vanish on "broken"
-    DrawHeartFilled(p, s);
-    if (state == 1) DrawHeartCrack(p, s);
-}
-
-
-
-
-// Returns 0=full, 1=cracked, 2=broken for heart index i (0..HEARTS-1)
-static int HeartStateFromHP(int hp, int i) {
-    // Heart 0 covers HP 6..5, heart 1 covers 4..3, heart 2 covers 2..1
-    int value = hp - (HP_MAX - (i + 1) * 2); // maps to {<=0,1,>=2}
-    if (value >= 2) return 0;  // full
-    if (value == 1) return 1;  // cracked
-    return 2;                  // broken
-}
-
-// shotgun helper
-static void FireShotgun(Vector2 from, Vector2 to) {
-    float dx = to.x - from.x;
-    float dy = to.y - from.y;
-    float base = atan2f(dy, dx);
-
-    float spread = SHOTGUN_SPREAD_DEG * (PI/180.0f);
-    int n = SHOTGUN_PELLETS;
-
-    for (int i = 0; i <n; ++i) {
-        float t = (n == 1) ? 0.0f : (float)i/(float)(n-1);      // 0..1
-        float ang = base + (t - 0.5f) * 2.0f * spread;          // center→edges
-        Vector2 dirPoint = (Vector2){ from.x + cosf(ang), from.y + sinf(ang) };
-        AddBullet(from, dirPoint);                              // your AddBullet normalizes
+// F3 overlay, right of the profiler: what each subsystem holds (heap, plus the textures
+// and fixed buffers it noted), its peak, and what it allocated during the last frame
+static void DrawMemory(const MemCounts *lastFrame, int allocFrames) {
+    int x = 330, y = 60, line = 14;
+    DrawRectangle(x - 6, y - 6, 330, line * (MEM_TAG_COUNT + 3) + 8, Fade(BLACK, 0.7f));
+    DrawText("memory         now KB    peak KB    allocs   frame", x, y, 10, WHITE);
+    for (int t = 0; t < MEM_TAG_COUNT; ++t) {
+        MemStats st = MemGetTagStats((MemTag)t);
+        y += line;
+        Color c = lastFrame->allocs[t] ? RED : WHITE;
+        DrawText(MemTagName((MemTag)t), x, y, 10, c);
+        DrawText(TextFormat("%9.1f  %9.1f  %8llu  %5llu", st.bytes / 1024.0, st.peakBytes / 1024.0,
+                            (unsigned long long)st.allocs, (unsigned long long)lastFrame->allocs[t]), x + 70, y, 10, c);
     }
-
-    // draw one bright center trace for feedback
-    Vector2 centerPoint = (Vector2){ from.x + cosf(base), from.y + sinf(base) };
-    AddTrace(from, centerPoint);
-    
+    MemStats all = MemGetStats();
+    y += line;
+    DrawText(TextFormat("total %.1f KB, peak %.1f KB", all.bytes / 1024.0, all.peakBytes / 1024.0), x, y, 10, WHITE);
+    y += line;
+    DrawText(TextFormat("frames that allocated: %d", allocFrames), x, y, 10, allocFrames ? YELLOW : WHITE);
 }
 
 
 /**
  * request anti aliasing and vsync before opening window
+ * --seed N  play a specific run (default: time based)
+ * --hz N    sim tick rate (default SIM_TICK_HZ)
+ * --record file.ntr   save every tick's input, play it back with bin/headless --replay
+ * --threads N  sim worker threads (default: one per core; 1 = everything on the main thread)
+ * --telemetry file.ntt   log spawns, kills, hits, game overs, entity counts and frame
+ *           times (src/telemetry.h), summarize it with bin/telsum
+ * --coop 0|1 --port P --peer-port Q [--delay N]   two-player co-op with another instance
+ *           on this machine (src/net.h), e.g. --coop 0 --port 47100 --peer-port 47101 and
+ *           --coop 1 --port 47101 --peer-port 47100. both need the same --seed (default 1234)
+ * F5 quick-save, F9 back to the quick-save (not while recording or in co-op, the replay /
+ * the other side couldn't follow)
  */
-int main(void) {
-    SetConfigFlags(FLAG_MSAA_4X_HINT | FLAG_VSYNC_HINT); 
-    InitWindow(SCREEN_W, SCREEN_H, "NULL TERMINATOR — Controls Sandbox");
-    SetTargetFPS(60);
+int main(int argc, char **argv) {
+    uint64_t seed = (uint64_t)time(NULL);
+    int hz = SIM_TICK_HZ;
+    const char *recordPath = NULL, *telemetryPath = NULL;
+    int threads = JobsCpuCount();
+    int coop = -1, port = 0, peerPort = 0, delay = 2;
+    bool seeded = false;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--seed") == 0) { seed = strtoull(argv[++i], NULL, 10); seeded = true; }
+        else if (strcmp(argv[i], "--hz") == 0) hz = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--record") == 0) recordPath = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--telemetry") == 0) telemetryPath = argv[++i];
+        else if (strcmp(argv[i], "--coop") == 0) coop = atoi(argv[++i]) != 0;
+        else if (strcmp(argv[i], "--port") == 0) port = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--peer-port") == 0) peerPort = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--delay") == 0) delay = atoi(argv[++i]);
+    }
+    if (coop >= 0) {
+        if (!seeded) seed = 1234;
+        recordPath = NULL;        // one side's inputs alone don't replay
+    }
 
-    // lock the “player” at center for now, will upgrade later
-    Vector2 player = { SCREEN_W * 0.5f, SCREEN_H * 0.5f };
+    SetConfigFlags(FLAG_MSAA_4X_HINT | FLAG_VSYNC_HINT);
+    InitWindow(SCREEN_W, SCREEN_H, "NULL TERMINATOR — Controls Sandbox");
+    // no SetTargetFPS(60) anymore: vsync paces the frames and the sim runs at its own
+    // fixed rate, so a 144Hz screen just gets smoother interpolation
 
     HideCursor();
 
-    int score = 0;
-    int highScore = 0;
-    bool newHighBanner = false;
-    float newHighTimer = 0.0f;
+    Leaderboard scores;
+    if (!LeaderboardLoad(&scores, SCORES_FILE)) {
+        // first run since the switch: carry the old number over, it gets written with the next run
+        int legacy = LoadLegacyHighScore(LEGACY_HS_FILE);
+        if (legacy > 0) LeaderboardInsert(&scores, (ScoreEntry){ legacy, 0.0f, 0 });
+    }
 
-    float timeSinceStart = 0.0f;
-    highScore = LoadHighScore(HS_FILE);
+    // the high score is part of the state, so co-op starts both sides from 0
+    static GameState game;
+    if (!SimInit(&game, coop >= 0 ? 0 : LeaderboardBest(&scores), seed)) {
+        CloseWindow();
+        return 1;
+    }
+    GameState *g = &game;
+
+    // the sim only farms work out once there are thousands of entities, so extra
+    // threads just sleep during normal play
+    static JobSystem jobs;
+    if (threads > 1 && JobsInit(&jobs, threads)) g->jobs = &jobs;
+
+    SimClock clock;
+    SimClockInit(&clock, hz);
+
+    // co-op: the session runs the ticks instead of the clock, rolling back when the
+    // other side's input turns out different from the guess
+    static NetLink link;
+    static NetSession net;
+    bool online = false;
+    if (coop >= 0) {
+        SimSetPlayers(g, 2);
+        online = NetLinkOpen(&link, (uint16_t)port, (uint16_t)peerPort) &&
+                 NetSessionInit(&net, g, &link, coop, delay, clock.hz);
+        if (!online) {
+            fprintf(stderr, "co-op: can't use 127.0.0.1:%d, playing solo\n", port);
+            NetLinkClose(&link);
+            SimSetPlayers(g, 1);
+        }
+    }
+
+    // gameplay log, written from a thread of its own like the scores
+    static Telemetry telemetry;
+    if (telemetryPath) {
+        if (TelemetryOpen(&telemetry, telemetryPath, seed, clock.hz, g->tick)) g->telemetry = &telemetry;
+        else fprintf(stderr, "telemetry: can't write %s\n", telemetryPath);
+    }
+
+    ReplayWriter rec = {0};
+    if (recordPath && ReplayWriterOpen(&rec, recordPath, seed, clock.hz, g->highScore)) {
+        clock.onTick = ReplayTickHook;
+        clock.onTickUser = &rec;
+    }
 
     // minimal screen shake on click (for vibbbeeessss)
-    float shakeTime = 0.0f;
+    // cosmetic only, so it gets its own rng and never touches the sim's
     float shakeMag  = 4.0f;
+    Rng shakeRng;
+    RngSeed(&shakeRng, seed ^ 0x5348414B45ull);
+
+    // what the sim looks like this frame, rebuilt before drawing
+    static RenderList render;
+    RenderInit(&render);
+    Atlas atlas = AtlasBuild();
+
+    // cosmetic like the shake, so its own seed
+    static ParticleSystem particles;
+    if (!ParticlesInit(&particles, seed ^ 0x5041525453ull)) {
+        AtlasUnload(&atlas);
+        RenderFree(&render);
+        SimFree(g);
+        if (g->jobs) JobsShutdown(&jobs);
+        CloseWindow();
+        return 1;
+    }
+    static Hud hud;
+    if (!HudInit(&hud, &atlas)) {
+        ParticlesFree(&particles);
+        AtlasUnload(&atlas);
+        RenderFree(&render);
+        SimFree(g);
+        if (g->jobs) JobsShutdown(&jobs);
+        CloseWindow();
+        return 1;
+    }
 
-    float fireCooldown = 0.0f; 
-
-    float spawnTimer = 0.0f;
+    // every finished run goes to the I/O thread, the frame never touches the disk
+    static ScoreWriter scoreWriter;
+    ScoreWriterStart(&scoreWriter, SCORES_FILE, &scores);
 
-    int hp = HP_MAX;
-    float hurtTimer = 0;
+    // F5 / F9
+    Snapshot quickSave = {0};
 
-    GameState state = STATE_PLAYING;
+    // profiler overlay (F3) and dump (F4), stats refreshed a few times a second
+    bool showProfiler = false;
+    ProfStats profStats[PROF_PHASE_COUNT] = {0};
+    float profRefresh = 0.0f;
 
-    bool hasShotgun = false;
-    bool justUnlockedShotgun = false;
-    float shotgunBannerTimer = 0.0f;
+    // allocations per subsystem over the last frame, for the same overlay. the first
+    // frames fill the render lists, only frames after that count as allocating
+    MemCounts lastFrameAllocs = {0};
+    int allocFrames = 0;
+    long frameNo = 0;
 
     // game loop
     while (!WindowShouldClose()) {
+        PROF_BEGIN(PROF_FRAME);
+        MemCounts frameStart = MemGetCounts();
 
-        float dt = GetFrameTime();
+        PROF_BEGIN(PROF_INPUT);
         Vector2 mouse = GetMousePosition();
 
-        if (newHighTimer > 0.0f) newHighTimer -= dt;
-
-        if (state == STATE_PLAYING) {
-            // cooldown tick
-            if (fireCooldown > 0.0f) fireCooldown -= dt;
-
-            // upgrade unlock
-            if (!hasShotgun && score >= SHOTGUN_UNLOCK_AFTER_SCORE) {
-                hasShotgun = true;
-                justUnlockedShotgun = true;
-                shotgunBannerTimer  = 2;   // show for ~1.5 seconds
-                shakeTime = 0.08f; // tiny feedback bump 
-            }
-
-            if (shotgunBannerTimer > 0.0f) shotgunBannerTimer -= dt;
-
-
-            bool wantsFire = IsMouseButtonDown(MOUSE_LEFT_BUTTON) || IsKeyDown(KEY_SPACE);
-            if (wantsFire && fireCooldown <= 0.0f) {
-                if (hasShotgun) {
-                    FireShotgun(player, mouse);
-                    fireCooldown = 1.0f / SHOTGUN_FIRE_RATE;
-                } else {
-                    AddTrace(player, mouse);
-                    AddBullet(player, mouse);
-                    fireCooldown = 1.0f / FIRE_RATE;
-                }
-                shakeTime = 0.06f;
-            }
-
-
-            // updates
-            UpdateTraces(dt);
-            UpdateBullets(dt);
-            if (shakeTime > 0.0f) shakeTime -= dt;
-
-            timeSinceStart += dt;
-
-            // spawn gets faster over time (linear, clamped)
-            float currentSpawnInterval = SPAWN_BASE - SPAWN_RAMP * timeSinceStart;
-            if (currentSpawnInterval < SPAWN_MIN) currentSpawnInterval = SPAWN_MIN;
-
-            // enemies get faster over time (linear, clamped)
-            float currentEnemySpeed = ENEMY_SPEED_BASE + ENEMY_SPEED_RAMP * timeSinceStart;
-            if (currentEnemySpeed > ENEMY_SPEED_MAX) currentEnemySpeed = ENEMY_SPEED_MAX;
-
-
-            // spawn
-            spawnTimer -= dt;
-            if (spawnTimer <= 0.0f) {
-                AddEnemy(player, currentEnemySpeed);
-                spawnTimer = currentSpawnInterval;
-            }
+        SimInput in = {
+            .aim     = ReplaySnapAim((Vec2){ mouse.x, mouse.y }),
+            // pressed too: a tap that went down and up between two frames still shoots.
+            // raylib only polls input here, once per frame, so the 1 kHz input thread
+            // (src/input.h) has nothing faster to read in the window build
+            .fire    = IsMouseButtonDown(MOUSE_LEFT_BUTTON) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON) || IsKeyDown(KEY_SPACE),
+            .restart = IsKeyPressed(KEY_R),
+        };
+        if (IsKeyPressed(KEY_F3)) showProfiler = !showProfiler;
+        if (IsKeyPressed(KEY_F5) && !online) SnapshotSave(&quickSave, g);
+        if (IsKeyPressed(KEY_F9) && quickSave.size > 0 && !clock.onTick && !online) {
+            if (!SnapshotRestore(&quickSave, g)) SimReset(g);
+        }
+        if (IsKeyPressed(KEY_F4)) {
+            ProfWriteCsv("profile.csv");
+            ProfWriteChromeTrace("profile.json");
+        }
+        PROF_END(PROF_INPUT);
+        unsigned events;
+        float alpha;                            // 0..1 into the next tick
+        if (online) {
+            NetAdvance(&net, &in, GetFrameTime());
+            events = net.events;
+            alpha = net.acc / net.step;
+        } else {
+            SimAdvance(g, &clock, &in, GetFrameTime());
+            events = clock.events;
+            alpha = clock.acc / clock.step;
+        }
 
-            // bullet to enemy
-            for (int ei = enemyCount - 1; ei >= 0; --ei) {
-                Enemy *e = &enemies[ei];
-                float killRadius = ENEMY_RADIUS + BULLET_RADIUS;
-                for (int bi = bulletCount - 1; bi >= 0; --bi) {
-                    Bullet *b = &bullets[bi];
-                    if (Dist2(e->pos, b->pos) <= killRadius * killRadius) {
-                        enemies[ei] = enemies[enemyCount - 1]; enemyCount--;
-                        bullets[bi] = bullets[bulletCount - 1]; bulletCount--;
-                        shakeTime = 0.06f; score += 10;
-                        break;
-                    }
-                }
-            }
+        if (g->telemetry) TelemetryFrame(g->telemetry, g->tick, GetFrameTime());
 
-            // enemy to player
-            if (hurtTimer > 0.0f) hurtTimer -= dt;
-
-            for (int ei = enemyCount - 1; ei >= 0; --ei) {
-                Enemy *e = &enemies[ei];
-                float touchRadius = ENEMY_RADIUS + PLAYER_RADIUS;
-
-                if (Dist2(e->pos, player) <= touchRadius * touchRadius) {
-                    if (hurtTimer <= 0.0f) {
-                        if (hp > 0) hp -= 1;
-
-                        if (hp <= 0) {
-                            // GAME OVER: update high score once + show banner
-                            if (score > highScore) {
-                                highScore = score;
-                                SaveHighScore(HS_FILE, highScore);
-                                newHighBanner = true;
-                                newHighTimer  = 2.0f;   // 2 seconds
-                            }
-                            state = STATE_GAME_OVER;
-                        }
-
-                        // feedback + i-frames
-                        hurtTimer = HIT_IFRAME;
-                        shakeTime = 0.12f;
-                    }
-
-                    // remove this enemy either way
-                    enemies[ei] = enemies[enemyCount - 1];
-                    enemyCount--;
-                }
-            
-            }
-
-            UpdateEnemies(dt);
-
-        // STATE_GAME_OVER
-        } else { 
-            if (IsKeyPressed(KEY_R)) {
-                // reset run
-                score = 0;
-                hp = HP_MAX;
-                hurtTimer = 0.0f;
-                shakeTime = 0.0f;
-                fireCooldown = 0.0f;
-                spawnTimer = 0.0f;
-                timeSinceStart = 0.0f;
-
-                enemyCount = 0;
-                bulletCount = 0;
-                traceCount  = 0;
-                hasShotgun = false;
-                justUnlockedShotgun = false;
-                shotgunBannerTimer = 0.0f;
-                newHighBanner = false;
-                newHighTimer = 0.0f;
-
-                state = STATE_PLAYING;   
-            }
+        // co-op: only a game over every input up to has been confirmed for, a predicted
+        // one can still be rolled back (and may be a few ticks into the next run by now)
+        if (online && net.overFinal) {
+            ScoreWriterSubmit(&scoreWriter, (ScoreEntry){ net.overScore, net.overTime, (int64_t)time(NULL) });
+        } else if (!online && (events & SIM_EVENT_GAME_OVER)) {
+            ScoreWriterSubmit(&scoreWriter, (ScoreEntry){ g->score, g->timeSinceStart, (int64_t)time(NULL) });
         }
 
 
         // camera shake offset (no real reason, just tuff)
         Vector2 cam = {0};
-        if (shakeTime > 0.0f) {
-            cam.x = (GetRandomValue(-100, 100) / 100.0f) * shakeMag;
-            cam.y = (GetRandomValue(-100, 100) / 100.0f) * shakeMag;
+        if (g->shakeTime > 0.0f) {
+            cam.x = (RngRange(&shakeRng, -100, 100) / 100.0f) * shakeMag;
+            cam.y = (RngRange(&shakeRng, -100, 100) / 100.0f) * shakeMag;
         }
 
+        // bursts for whatever died / got hit / fired this frame, then move them all
+        PROF_BEGIN(PROF_PARTICLES);
+        ParticlesEmitFx(&particles, g);
+        ParticlesUpdate(&particles, GetFrameTime());
+        PROF_END(PROF_PARTICLES);
+
+        // interpolate, shake and cull everything once, then draw it in a few batches
+        PROF_BEGIN(PROF_RENDER_BUILD);
+        RenderBuild(&render, g, alpha, (Vec2){ cam.x, cam.y });
+        RenderAddParticles(&render, &particles, (Vec2){ cam.x, cam.y });
+        PROF_END(PROF_RENDER_BUILD);
+
+        // HUD layers only get re-rendered when what they show changed
+        PROF_BEGIN(PROF_HUD_REDRAW);
+        HudUpdate(&hud, g);
+        PROF_END(PROF_HUD_REDRAW);
+
         // draw
         BeginDrawing();
             ClearBackground(BLACK);
 
-            // --- Traces ---
-            for (int i = 0; i < traceCount; ++i) {
-                float t = traces[i].life / TRACE_LIFE; // 1 -> 0
-                float thickness = 3.0f * t + 1.0f;
-                Vector2 A = (Vector2){ traces[i].a.x + cam.x, traces[i].a.y + cam.y };
-                Vector2 B = (Vector2){ traces[i].b.x + cam.x, traces[i].b.y + cam.y };
-                DrawLineEx(A, B, thickness, WHITE);
-                DrawCircleV(A, 4.0f * t + 1.0f, WHITE); // muzzle flash
-            }
+            // --- Traces (line + muzzle flash) ---
+            PROF_BEGIN(PROF_DRAW_TRACES);
+            SubmitLines(&render.groups[RGROUP_TRACES]);
+            SubmitCircles(&render.groups[RGROUP_FLASHES], &atlas, SPR_CIRCLE);
+            PROF_END(PROF_DRAW_TRACES);
 
             // --- Bullets ---
-            for (int i = 0; i < bulletCount; ++i) {
-                Vector2 p = { bullets[i].pos.x + cam.x, bullets[i].pos.y + cam.y };
-                DrawCircleV(p, BULLET_RADIUS, WHITE);
-            }
+            PROF_BEGIN(PROF_DRAW_BULLETS);
+            SubmitCircles(&render.groups[RGROUP_BULLETS], &atlas, SPR_CIRCLE);
+            PROF_END(PROF_DRAW_BULLETS);
 
             // --- Enemies ---
-            for (int i = 0; i < enemyCount; ++i) {
-                Vector2 p = { enemies[i].pos.x + cam.x, enemies[i].pos.y + cam.y };
-                DrawCircleV(p, ENEMY_RADIUS, WHITE);
-            }
+            PROF_BEGIN(PROF_DRAW_ENEMIES);
+            SubmitCircles(&render.groups[RGROUP_ENEMIES], &atlas, SPR_ENEMY);
+            PROF_END(PROF_DRAW_ENEMIES);
 
-            // --- HUD: score + hearts + labels ---
-            {
-                const char *scoreText = TextFormat("Score: %d", score);
-                int fontSize = 18;
-                int scoreWidth = MeasureText(scoreText, fontSize);
-                int scoreX = SCREEN_W - scoreWidth - 16;
-                int scoreY = 12;
-
-                DrawText(scoreText, scoreX, scoreY, fontSize, WHITE);
-                DrawText("Aim with mouse. Click to fire. ESC=Quit.", 16, 12, 18, WHITE);
-                DrawText(TextFormat("High Score: %d", highScore), 16, 34, 18, WHITE);
-
-                // hearts row (right-aligned under score)
-                int heartsY = scoreY + fontSize + 6;
-                float s = HEART_SIZE;
-                for (int i = 0; i < HEARTS; ++i) {
-                    int idx = HEARTS - 1 - i;  // 2,1,0
-                    int state = HeartStateFromHP(hp, idx);
-                    float xRight = SCREEN_W - 16 - (i * (s + HEART_GAP));
-                    Vector2 center = (Vector2){ xRight - s*0.5f, heartsY + s*0.4f };
-                    DrawHeartIcon(center, s, state);
-                }
-            }
-
-            // --- Shotgun unlock banner ---
-            if (shotgunBannerTimer > 0.0f || justUnlockedShotgun) {
-                const float duration = 1.5f;
-                float a = shotgunBannerTimer / duration;   // 0..1
-                float alpha = EaseBanner(a);
+            // --- Particles (death bursts, sparks, hit debris) ---
+            PROF_BEGIN(PROF_DRAW_PARTICLES);
+            SubmitCircles(&render.groups[RGROUP_PARTICLES], &atlas, SPR_CIRCLE);
+            PROF_END(PROF_DRAW_PARTICLES);
 
-                const char *msg = "SHOTGUN UNLOCKED";
-                int fs = 28;
-                int w = MeasureText(msg, fs);
-                DrawText(msg, (SCREEN_W - w)/2, 80, fs, Fade(WHITE, alpha));
-
-                if (shotgunBannerTimer <= 0.0f) justUnlockedShotgun = false;
-            }
+            // --- HUD: score + hearts + labels ---
+            PROF_BEGIN(PROF_DRAW_HUD);
+            HudDraw(&hud, HUD_STATUS, 1.0f);
+            PROF_END(PROF_DRAW_HUD);
 
             // --- Player + and crosshair ---
-            {
-                Color playerColor;
+            for (int k = 0; k < g->players; ++k) {
+                bool blink = g->hurtTimer > 0.0f && ((int)(g->hurtTimer * 20) % 2 == 0);
+                Vector2 player = V(g->player[k]);
+                AtlasDraw(&atlas, blink ? SPR_PLAYER_HURT : SPR_PLAYER, (Vector2){ player.x + cam.x, player.y + cam.y });
+            }
 
-                if (hurtTimer > 0.0f && ((int)(hurtTimer * 20) % 2 == 0)) {
-                    playerColor = BLACK;
-                } else {
-                    playerColor = WHITE;
-                }
+            AtlasDraw(&atlas, SPR_CROSSHAIR, mouse);
 
-                DrawCircleV((Vector2){player.x + cam.x, player.y + cam.y}, PLAYER_RADIUS, playerColor);
-                DrawCircleV((Vector2){player.x + cam.x, player.y + cam.y}, PLAYER_RADIUS - 2, BLACK);
+            // --- Shotgun unlock banner ---
+            PROF_BEGIN(PROF_DRAW_BANNERS);
+            if (g->shotgunBannerTimer > 0.0f || g->justUnlockedShotgun) {
+                const float duration = 1.5f;
+                float a = g->shotgunBannerTimer / duration;   // 0..1
+                HudDraw(&hud, HUD_BANNER_SHOTGUN, EaseBanner(a));
             }
 
-            DrawCrosshair(mouse);
-
             // --- Game over overlay ---
-            if (state == STATE_GAME_OVER) {
+            if (g->state == STATE_GAME_OVER) {
                 DrawRectangle(0, 0, SCREEN_W, SCREEN_H, Fade(BLACK, 0.35f));
-                const char *title = "PR0CESS TERMINATED";
-                int titleSize = 36;
-                int titleW = MeasureText(title, titleSize);
-                DrawText(title, (SCREEN_W - titleW)/2, SCREEN_H/2 - 40, titleSize, WHITE);
-
-                const char *sub = TextFormat("Score: %d   -   Press R to restart", score);
-                int subSize = 20;
-                int subW = MeasureText(sub, subSize);
-                DrawText(sub, (SCREEN_W - subW)/2, SCREEN_H/2 + 6, subSize, WHITE);
+                HudDraw(&hud, HUD_GAME_OVER, 1.0f);
             }
 
             // --- NEW HIGH SCORE banner ---
-            if (newHighBanner || newHighTimer > 0.0f) {
+            if (g->newHighBanner || g->newHighTimer > 0.0f) {
                 const float duration = 2.0f; // must match start value
-                float a = newHighTimer / duration; // 0..1
-                float alpha = EaseBanner(a);
-
-                const char *msg = "NEW HIGH SCORE!";
-                int fs = 32;
-                int w  = MeasureText(msg, fs);
-                int x = (SCREEN_W - w)/2;
-                int y = 120;
-                DrawText(msg, x+2, y+2, fs, Fade(BLACK, alpha));  // shadow
-                DrawText(msg, x,   y,   fs, Fade(WHITE, alpha));
-
-                if (newHighTimer <= 0.0f) newHighBanner = false;
+                float a = g->newHighTimer / duration; // 0..1
+                HudDraw(&hud, HUD_BANNER_HIGH, EaseBanner(a));  // shadow is baked in
+            }
+
+            if (online && !net.heard) {
+                const char *msg = TextFormat("waiting for player %d on port %d...", 2 - coop, peerPort);
+                DrawText(msg, (SCREEN_W - MeasureText(msg, 20)) / 2, SCREEN_H / 2 + 60, 20, WHITE);
+            }
+            PROF_END(PROF_DRAW_BANNERS);
+
+            if (showProfiler) {
+                profRefresh -= GetFrameTime();
+                if (profRefresh <= 0.0f) {
+                    ProfSummarize(profStats);
+                    profRefresh = 0.25f;
+                }
+                DrawProfiler(profStats, hud.redraws);
+                DrawMemory(&lastFrameAllocs, allocFrames);
             }
 
         EndDrawing();
+
+        MemCounts frameEnd = MemGetCounts();
+        bool allocated = false;
+        for (int t = 0; t < MEM_TAG_COUNT; ++t) {
+            lastFrameAllocs.allocs[t] = frameEnd.allocs[t] - frameStart.allocs[t];
+            if (lastFrameAllocs.allocs[t]) allocated = true;
+        }
+        if (allocated && frameNo > 60) allocFrames++;
+        frameNo++;
+        PROF_END(PROF_FRAME);
     }
 
 
+    if (clock.onTick) ReplayWriterClose(&rec, g);
+    if (g->telemetry) TelemetryClose(g->telemetry);
+    if (online) {
+        NetSessionFree(&net);
+        NetLinkClose(&link);
+    }
+    ScoreWriterStop(&scoreWriter);
+    SnapshotFree(&quickSave);
+    HudUnload(&hud);
+    ParticlesFree(&particles);
+    AtlasUnload(&atlas);
+    RenderFree(&render);
+    SimFree(g);
+    if (g->jobs) JobsShutdown(&jobs);
     ShowCursor();
     CloseWindow();
     return 0;
 }
-
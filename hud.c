@@ -0,0 +1,129 @@
+// NULL TERMINATOR — retained HUD
+
+#include "hud.h"
+#include "mem.h"
+
+#define HUD_FONT    18
+#define HUD_MARGIN  16
+#define HEART_GAP   10        // pixels between hearts
+
+#define STATUS_H    64        // tall enough for the two text lines and the hearts row
+#define GAME_OVER_Y (SCREEN_H/2 - 40)
+#define GAME_OVER_H 72
+
+// Returns 0=full, 1=cracked, 2=broken for heart index i (0..HEARTS-1)
+static int HeartStateFromHP(int hp, int i) {
+    // Heart 0 covers HP 6..5, heart 1 covers 4..3, heart 2 covers 2..1
+    int value = hp - (HP_MAX - (i + 1) * 2); // maps to {<=0,1,>=2}
+    if (value >= 2) return 0;  // full
+    if (value == 1) return 1;  // cracked
+    return 2;                  // broken
+}
+
+// true (and remembers the new key) if the layer has to be drawn again
+static bool Stale(HudLayer *l, int a, int b, int c) {
+    if (l->drawn && l->key[0] == a && l->key[1] == b && l->key[2] == c) return false;
+    l->key[0] = a; l->key[1] = b; l->key[2] = c;
+    l->drawn = true;
+    return true;
+}
+
+static bool MakeLayer(HudLayer *l, float x, float y, int w, int h) {
+    l->target = LoadRenderTexture(w, h);
+    l->pos = (Vector2){ x, y };
+    l->drawn = false;
+    if (l->target.id) MemNoteHeld(MEM_TEXT, (int64_t)w * h * 4);     // VRAM, rgba8
+    return l->target.id != 0;
+}
+
+static void BeginLayer(Hud *h, HudLayer *l) {
+    BeginTextureMode(l->target);
+    ClearBackground(BLANK);
+    h->redraws++;
+}
+
+// fixed-text banner, measured and drawn exactly once
+static bool BakeBanner(Hud *h, HudLayer *l, const char *msg, int fs, int y, bool shadow) {
+    int w = MeasureText(msg, fs);
+    if (!MakeLayer(l, (SCREEN_W - w)/2, y, w + 2, fs + 2)) return false;
+    BeginLayer(h, l);
+    if (shadow) DrawText(msg, 2, 2, fs, BLACK);
+    DrawText(msg, 0, 0, fs, WHITE);
+    EndTextureMode();
+    l->drawn = true;
+    return true;
+}
+
+bool HudInit(Hud *h, const Atlas *atlas) {
+    *h = (Hud){ .atlas = atlas };
+    bool ok = MakeLayer(&h->layers[HUD_STATUS], 0, 0, SCREEN_W, STATUS_H)
+           && MakeLayer(&h->layers[HUD_GAME_OVER], 0, GAME_OVER_Y, SCREEN_W, GAME_OVER_H)
+           && BakeBanner(h, &h->layers[HUD_BANNER_SHOTGUN], "SHOTGUN UNLOCKED", 28, 80, false)
+           && BakeBanner(h, &h->layers[HUD_BANNER_HIGH], "NEW HIGH SCORE!", 32, 120, true);
+    if (!ok) HudUnload(h);
+    return ok;
+}
+
+void HudUnload(Hud *h) {
+    for (int i = 0; i < HUD_LAYER_COUNT; ++i) {
+        const RenderTexture2D *t = &h->layers[i].target;
+        if (!t->id) continue;
+        MemNoteHeld(MEM_TEXT, -(int64_t)t->texture.width * t->texture.height * 4);
+        UnloadRenderTexture(*t);
+        h->layers[i].target.id = 0;
+    }
+}
+
+int HudUpdate(Hud *h, const GameState *g) {
+    int before = h->redraws;
+
+    HudLayer *st = &h->layers[HUD_STATUS];
+    if (Stale(st, g->score, g->highScore, g->hp)) {
+        BeginLayer(h, st);
+        const char *scoreText = TextFormat("Score: %d", g->score);
+        int scoreWidth = MeasureText(scoreText, HUD_FONT);
+        int scoreY = 12;
+        DrawText(scoreText, SCREEN_W - scoreWidth - HUD_MARGIN, scoreY, HUD_FONT, WHITE);
+        DrawText("Aim with mouse. Click to fire. ESC=Quit.", HUD_MARGIN, 12, HUD_FONT, WHITE);
+        DrawText(TextFormat("High Score: %d", g->highScore), HUD_MARGIN, 34, HUD_FONT, WHITE);
+
+        // hearts row (right-aligned under score)
+        int heartsY = scoreY + HUD_FONT + 6;
+        float s = HEART_SIZE;
+        for (int i = 0; i < HEARTS; ++i) {
+            int idx = HEARTS - 1 - i;  // 2,1,0
+            int state = HeartStateFromHP(g->hp, idx);
+            float xRight = SCREEN_W - HUD_MARGIN - (i * (s + HEART_GAP));
+            Vector2 center = (Vector2){ xRight - s*0.5f, heartsY + s*0.4f };
+            // state: 0=full, 1=cracked (show crack), 2=broken (draw nothing)
+            if (state != 2) AtlasDraw(h->atlas, state == 1 ? SPR_HEART_CRACKED : SPR_HEART_FULL, center);
+        }
+        EndTextureMode();
+    }
+
+    // only shown on the game-over screen, so only kept fresh there
+    HudLayer *go = &h->layers[HUD_GAME_OVER];
+    if (g->state == STATE_GAME_OVER && Stale(go, g->score, 0, 0)) {
+        BeginLayer(h, go);
+        const char *title = "PR0CESS TERMINATED";
+        int titleSize = 36;
+        int titleW = MeasureText(title, titleSize);
+        DrawText(title, (SCREEN_W - titleW)/2, 0, titleSize, WHITE);
+
+        const char *sub = TextFormat("Score: %d   -   Press R to restart", g->score);
+        int subSize = 20;
+        int subW = MeasureText(sub, subSize);
+        DrawText(sub, (SCREEN_W - subW)/2, 46, subSize, WHITE);
+        EndTextureMode();
+    }
+
+    return h->redraws - before;
+}
+
+void HudDraw(const Hud *h, HudLayerId id, float alpha) {
+    const HudLayer *l = &h->layers[id];
+    if (!l->drawn) return;
+    // render textures come out upside down, hence the negative height
+    Rectangle src = { 0, 0, (float)l->target.texture.width, -(float)l->target.texture.height };
+    DrawTextureRec(l->target.texture, src, l->pos, Fade(WHITE, alpha));
+}
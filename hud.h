@@ -0,0 +1,46 @@
+// NULL TERMINATOR — retained HUD
+// Score, high score, hearts and the help line only change when the score, high score or
+// hp do, so they're drawn once into a RenderTexture and every other frame just blits it.
+// Same for the game-over text (depends on the score) and the two banners, which are
+// fixed text where only the fade changes: baked once, drawn tinted.
+
+#ifndef NT_HUD_H
+#define NT_HUD_H
+
+#include "raylib.h"
+#include "atlas.h"
+#include "sim.h"
+
+typedef enum {
+    HUD_STATUS = 0,          // score, high score, hearts, help line (top of the screen)
+    HUD_GAME_OVER,           // title + final score
+    HUD_BANNER_SHOTGUN,
+    HUD_BANNER_HIGH,
+    HUD_LAYER_COUNT
+} HudLayerId;
+
+typedef struct {
+    RenderTexture2D target;
+    Vector2 pos;             // where it goes on screen
+    int key[3];              // what it was last drawn with
+    bool drawn;
+} HudLayer;
+
+typedef struct {
+    HudLayer layers[HUD_LAYER_COUNT];
+    const Atlas *atlas;
+    int redraws;             // layer re-renders so far, stays put while nothing changes
+} Hud;
+
+// needs a window. bakes the banners right away
+bool HudInit(Hud *h, const Atlas *atlas);
+void HudUnload(Hud *h);
+
+// re-render the layers whose inputs changed since last time. call before BeginDrawing;
+// returns how many layers it re-rendered (0 on almost every frame)
+int HudUpdate(Hud *h, const GameState *g);
+
+// blit one layer at its spot, alpha 0..1
+void HudDraw(const Hud *h, HudLayerId id, float alpha);
+
+#endif
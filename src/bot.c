@@ -0,0 +1,21 @@
+// NULL TERMINATOR — scripted player
+
+#include "bot.h"
+#include "replay.h"
+
+SimInput BotInput(const GameState *g, int player) {
+    Vec2 me = g->player[player];
+    SimInput in = { .aim = { me.x + 1.0f, me.y }, .fire = true };
+    float best = 1e30f;
+    const EntityPool *en = &g->enemies;
+    for (int i = 0; i < en->count; ++i) {
+        float ex = POOL_GET(en, x, i), ey = POOL_GET(en, y, i);
+        float dx = ex - me.x;
+        float dy = ey - me.y;
+        float d2 = dx*dx + dy*dy;
+        if (d2 < best) { best = d2; in.aim = (Vec2){ ex, ey }; }
+    }
+    in.aim = ReplaySnapAim(in.aim);
+    in.restart = (g->state == STATE_GAME_OVER);
+    return in;
+}
@@ -0,0 +1,13 @@
+// NULL TERMINATOR — scripted player
+// Aims at the closest enemy, holds fire, restarts on game over. Drives bin/headless
+// and every game in bin/sweep, so it has to stay cheap and deterministic.
+
+#ifndef NT_BOT_H
+#define NT_BOT_H
+
+#include "sim.h"
+
+// next tick's input for one of g's players (aim snapped like the game does)
+SimInput BotInput(const GameState *g, int player);
+
+#endif
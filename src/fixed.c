@@ -0,0 +1,179 @@
+// NULL TERMINATOR — fixed-point math
+
+#include "fixed.h"
+
+// round(sin(i * pi/512) * 65536), i = 0..256: one quarter turn in 256 steps
+static const int32_t sinTable[257] = {
+    0, 402, 804, 1206, 1608, 2010, 2412, 2814, 3216, 3617, 4019, 4420, 4821, 5222, 5623,
+    6023, 6424, 6824, 7224, 7623, 8022, 8421, 8820, 9218, 9616, 10014, 10411, 10808, 11204,
+    11600, 11996, 12391, 12785, 13180, 13573, 13966, 14359, 14751, 15143, 15534, 15924,
+    16314, 16703, 17091, 17479, 17867, 18253, 18639, 19024, 19409, 19792, 20175, 20557,
+    20939, 21320, 21699, 22078, 22457, 22834, 23210, 23586, 23961, 24335, 24708, 25080,
+    25451, 25821, 26190, 26558, 26925, 27291, 27656, 28020, 28383, 28745, 29106, 29466,
+    29824, 30182, 30538, 30893, 31248, 31600, 31952, 32303, 32652, 33000, 33347, 33692,
+    34037, 34380, 34721, 35062, 35401, 35738, 36075, 36410, 36744, 37076, 37407, 37736,
+    38064, 38391, 38716, 39040, 39362, 39683, 40002, 40320, 40636, 40951, 41264, 41576,
+    41886, 42194, 42501, 42806, 43110, 43412, 43713, 44011, 44308, 44604, 44898, 45190,
+    45480, 45769, 46056, 46341, 46624, 46906, 47186, 47464, 47741, 48015, 48288, 48559,
+    48828, 49095, 49361, 49624, 49886, 50146, 50404, 50660, 50914, 51166, 51417, 51665,
+    51911, 52156, 52398, 52639, 52878, 53114, 53349, 53581, 53812, 54040, 54267, 54491,
+    54714, 54934, 55152, 55368, 55582, 55794, 56004, 56212, 56418, 56621, 56823, 57022,
+    57219, 57414, 57607, 57798, 57986, 58172, 58356, 58538, 58718, 58896, 59071, 59244,
+    59415, 59583, 59750, 59914, 60075, 60235, 60392, 60547, 60700, 60851, 60999, 61145,
+    61288, 61429, 61568, 61705, 61839, 61971, 62101, 62228, 62353, 62476, 62596, 62714,
+    62830, 62943, 63054, 63162, 63268, 63372, 63473, 63572, 63668, 63763, 63854, 63944,
+    64031, 64115, 64197, 64277, 64354, 64429, 64501, 64571, 64639, 64704, 64766, 64827,
+    64884, 64940, 64993, 65043, 65091, 65137, 65180, 65220, 65259, 65294, 65328, 65358,
+    65387, 65413, 65436, 65457, 65476, 65492, 65505, 65516, 65525, 65531, 65535, 65536,};
+
+// round(atan(i/256) / 2pi * 65536), i = 0..256: tan 0..1 as binary angles (0..8192)
+static const int32_t atanTable[257] = {
+    0, 41, 81, 122, 163, 204, 244, 285, 326, 367, 407, 448, 489, 529, 570, 610, 651, 692,
+    732, 773, 813, 854, 894, 935, 975, 1015, 1056, 1096, 1136, 1177, 1217, 1257, 1297,
+    1337, 1377, 1417, 1457, 1497, 1537, 1577, 1617, 1656, 1696, 1736, 1775, 1815, 1854,
+    1894, 1933, 1973, 2012, 2051, 2090, 2129, 2168, 2207, 2246, 2285, 2324, 2363, 2401,
+    2440, 2478, 2517, 2555, 2594, 2632, 2670, 2708, 2746, 2784, 2822, 2860, 2897, 2935,
+    2973, 3010, 3047, 3085, 3122, 3159, 3196, 3233, 3270, 3307, 3344, 3380, 3417, 3453,
+    3490, 3526, 3562, 3599, 3635, 3670, 3706, 3742, 3778, 3813, 3849, 3884, 3920, 3955,
+    3990, 4025, 4060, 4095, 4129, 4164, 4199, 4233, 4267, 4302, 4336, 4370, 4404, 4438,
+    4471, 4505, 4539, 4572, 4605, 4639, 4672, 4705, 4738, 4771, 4803, 4836, 4869, 4901,
+    4933, 4966, 4998, 5030, 5062, 5094, 5125, 5157, 5188, 5220, 5251, 5282, 5313, 5344,
+    5375, 5406, 5437, 5467, 5498, 5528, 5559, 5589, 5619, 5649, 5679, 5708, 5738, 5768,
+    5797, 5826, 5856, 5885, 5914, 5943, 5972, 6000, 6029, 6058, 6086, 6114, 6142, 6171,
+    6199, 6227, 6254, 6282, 6310, 6337, 6365, 6392, 6419, 6446, 6473, 6500, 6527, 6554,
+    6580, 6607, 6633, 6660, 6686, 6712, 6738, 6764, 6790, 6815, 6841, 6867, 6892, 6917,
+    6943, 6968, 6993, 7018, 7043, 7068, 7092, 7117, 7141, 7166, 7190, 7214, 7238, 7262,
+    7286, 7310, 7334, 7358, 7381, 7405, 7428, 7451, 7475, 7498, 7521, 7544, 7566, 7589,
+    7612, 7635, 7657, 7679, 7702, 7724, 7746, 7768, 7790, 7812, 7834, 7856, 7877, 7899,
+    7920, 7942, 7963, 7984, 8005, 8026, 8047, 8068, 8089, 8110, 8131, 8151, 8172, 8192,};
+
+// round(2^34 / sqrt(i + 0.5)), i = 64..255: 1/sqrt seeds for m >> 24 (see Rsqrt)
+static const uint32_t rsqrtTable[192] = {
+    2139143874u, 2122751726u, 2106730729u, 2091067086u, 2075747707u, 2060760163u,
+    2046092644u, 2031733922u, 2017673311u, 2003900636u, 1990406202u, 1977180765u,
+    1964215505u, 1951502003u, 1939032214u, 1926798450u, 1914793358u, 1903009903u,
+    1891441346u, 1880081235u, 1868923385u, 1857961863u, 1847190978u, 1836605270u,
+    1826199490u, 1815968600u, 1805907755u, 1796012296u, 1786277740u, 1776699774u,
+    1767274245u, 1757997150u, 1748864636u, 1739872984u, 1731018611u, 1722298059u,
+    1713707990u, 1705245183u, 1696906526u, 1688689013u, 1680589738u, 1672605894u,
+    1664734763u, 1656973720u, 1649320221u, 1641771805u, 1634326089u, 1626980766u,
+    1619733600u, 1612582423u, 1605525136u, 1598559701u, 1591684144u, 1584896547u,
+    1578195052u, 1571577853u, 1565043197u, 1558589383u, 1552214758u, 1545917715u,
+    1539696693u, 1533550174u, 1527476684u, 1521474788u, 1515543090u, 1509680232u,
+    1503884893u, 1498155787u, 1492491662u, 1486891298u, 1481353508u, 1475877137u,
+    1470461055u, 1465104167u, 1459805400u, 1454563712u, 1449378085u, 1444247527u,
+    1439171070u, 1434147770u, 1429176706u, 1424256978u, 1419387709u, 1414568043u,
+    1409797142u, 1405074190u, 1400398389u, 1395768961u, 1391185142u, 1386646190u,
+    1382151377u, 1377699992u, 1373291341u, 1368924744u, 1364599536u, 1360315069u,
+    1356070705u, 1351865825u, 1347699819u, 1343572091u, 1339482060u, 1335429155u,
+    1331412818u, 1327432501u, 1323487671u, 1319577802u, 1315702382u, 1311860907u,
+    1308052885u, 1304277832u, 1300535277u, 1296824755u, 1293145812u, 1289498003u,
+    1285880891u, 1282294047u, 1278737053u, 1275209495u, 1271710972u, 1268241085u,
+    1264799448u, 1261385678u, 1257999402u, 1254640252u, 1251307868u, 1248001897u,
+    1244721991u, 1241467811u, 1238239020u, 1235035292u, 1231856302u, 1228701736u,
+    1225571280u, 1222464631u, 1219381487u, 1216321553u, 1213284541u, 1210270165u,
+    1207278145u, 1204308207u, 1201360079u, 1198433497u, 1195528200u, 1192643930u,
+    1189780435u, 1186937467u, 1184114781u, 1181312139u, 1178529303u, 1175766042u,
+    1173022127u, 1170297333u, 1167591440u, 1164904229u, 1162235487u, 1159585004u,
+    1156952571u, 1154337986u, 1151741047u, 1149161556u, 1146599320u, 1144054146u,
+    1141525847u, 1139014236u, 1136519130u, 1134040351u, 1131577719u, 1129131062u,
+    1126700207u, 1124284984u, 1121885226u, 1119500771u, 1117131454u, 1114777118u,
+    1112437604u, 1110112758u, 1107802427u, 1105506461u, 1103224711u, 1100957032u,
+    1098703280u, 1096463311u, 1094236988u, 1092024170u, 1089824724u, 1087638513u,
+    1085465407u, 1083305275u, 1081157988u, 1079023419u, 1076901444u, 1074791939u,
+};
+
+// sin over a quarter turn, w in 0..16384
+static Fixed QuarterSin(int32_t w) {
+    int32_t i = w >> 6, frac = w & 63;
+    if (i >= 256) return sinTable[256];
+    return sinTable[i] + (((sinTable[i + 1] - sinTable[i]) * frac) >> 6);
+}
+
+Fixed FxSin(uint16_t angle) {
+    int32_t w = angle & 0x3FFF;
+    switch (angle >> 14) {
+        case 0:  return  QuarterSin(w);
+        case 1:  return  QuarterSin(0x4000 - w);
+        case 2:  return -QuarterSin(w);
+        default: return -QuarterSin(0x4000 - w);
+    }
+}
+
+Fixed FxCos(uint16_t angle) {
+    return FxSin((uint16_t)(angle + 0x4000));
+}
+
+// atan of num/den for 0 <= num <= den, den > 0
+static int32_t OctantAtan(uint32_t num, uint32_t den) {
+    uint32_t t = (uint32_t)(((uint64_t)num << 16) / den);     // 0..65536
+    uint32_t i = t >> 8, frac = t & 255;
+    if (i >= 256) return atanTable[256];
+    return atanTable[i] + (int32_t)(((atanTable[i + 1] - atanTable[i]) * (int32_t)frac) >> 8);
+}
+
+uint16_t FxAtan2(Fixed y, Fixed x) {
+    uint32_t ax = x < 0 ? 0u - (uint32_t)x : (uint32_t)x;
+    uint32_t ay = y < 0 ? 0u - (uint32_t)y : (uint32_t)y;
+    if (ax == 0 && ay == 0) return 0;
+
+    int32_t a = ay <= ax ? OctantAtan(ay, ax) : 0x4000 - OctantAtan(ax, ay);   // 0..quarter
+    if (x < 0) a = 0x8000 - a;
+    if (y < 0) a = -a;
+    return (uint16_t)a;
+}
+
+uint32_t FxSqrt64(uint64_t v) {
+    uint64_t root = 0, bit = 1ull << 62;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+Fixed FxLength(Fixed x, Fixed y) {
+    uint64_t len2 = (uint64_t)((int64_t)x * x) + (uint64_t)((int64_t)y * y);
+    return (Fixed)FxSqrt64(len2);
+}
+
+// 2^46 / sqrt(m) for m in [2^30, 2^32): table seed good to ~8 bits, then two Newton
+// steps r = r * (3 - m*r^2) / 2, all in 64-bit integers
+static uint32_t Rsqrt(uint32_t m) {
+    uint64_t r = rsqrtTable[(m >> 24) - 64];
+    for (int k = 0; k < 2; ++k) {
+        uint64_t t = (uint64_t)m * ((r * r) >> 32);           // ~2^60 when r is right
+        uint64_t h = ((3ull << 60) - t) >> 30;                  // ~2^31
+        r = (r * h) >> 31;
+    }
+    return (uint32_t)r;
+}
+
+bool FxNormalize(Fixed *x, Fixed *y) {
+    uint32_t ax = *x < 0 ? 0u - (uint32_t)*x : (uint32_t)*x;
+    uint32_t ay = *y < 0 ? 0u - (uint32_t)*y : (uint32_t)*y;
+    uint32_t big = ax > ay ? ax : ay;
+    if (big == 0) return false;
+
+    // direction doesn't care about scale: bring the bigger side to 16 bits
+    int shift = (31 - __builtin_clz(big)) - 15;
+    if (shift > 0) { ax >>= shift; ay >>= shift; }
+    else           { ax <<= -shift; ay <<= -shift; }
+
+    // len^2 in [2^30, 2^33), as an even shift of m in [2^30, 2^32)
+    uint64_t len2 = (uint64_t)ax * ax + (uint64_t)ay * ay;
+    int half = len2 >> 32 ? 1 : 0;
+    uint64_t r = Rsqrt((uint32_t)(len2 >> (2 * half)));       // 2^46 / sqrt(len2 >> 2*half)
+
+    int out = 30 + half;                                        // 46 + half - 16
+    Fixed nx = (Fixed)(((uint64_t)ax * r) >> out), ny = (Fixed)(((uint64_t)ay * r) >> out);
+    *x = *x < 0 ? -nx : nx;
+    *y = *y < 0 ? -ny : ny;
+    return true;
+}
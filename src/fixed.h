@@ -0,0 +1,51 @@
+// NULL TERMINATOR — fixed-point math
+// 16.16 fixed point with table trig and an integer sqrt. `make FIXED=1` routes the sim's
+// direction math (aiming, enemy homing, the weapon fans) through here instead of libm,
+// whose sqrtf/atan2f/cosf/sinf aren't guaranteed to round the same on every machine.
+// Everything below is integer-only, so it gives the same bits everywhere.
+//
+// Angles are binary: 65536 per turn, so wrapping is just uint16 overflow.
+
+#ifndef NT_FIXED_H
+#define NT_FIXED_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef int32_t Fixed;
+
+#define FX_SHIFT 16
+#define FX_ONE   (1 << FX_SHIFT)
+#define FX_TURN  65536          // binary angle units per full turn
+
+// float <-> 16.16. the float side is exact for anything already on the 1/65536 grid
+// and within +-32768; lrintf rounds to nearest-even, same as every IEEE machine
+static inline Fixed FxFromFloat(float f) { return (Fixed)lrintf(f * (float)FX_ONE); }
+static inline float FxToFloat(Fixed x)   { return (float)x * (1.0f / (float)FX_ONE); }
+static inline Fixed FxMul(Fixed a, Fixed b) { return (Fixed)(((int64_t)a * b) >> FX_SHIFT); }
+static inline Fixed FxDiv(Fixed a, Fixed b) { return (Fixed)(((int64_t)a << FX_SHIFT) / b); }
+
+// degrees -> binary angle (rounded, may be negative)
+static inline int32_t FxAngleFromDeg(float deg) { return (int32_t)lrintf(deg * ((float)FX_TURN / 360.0f)); }
+
+// sin / cos of a binary angle, 16.16. quarter-wave table, linear in between
+// (worst case about 1 lsb off the true value)
+Fixed FxSin(uint16_t angle);
+Fixed FxCos(uint16_t angle);
+
+// angle of (x, y) as a binary angle, 0 along +x, counter-clockwise toward +y.
+// (0, 0) gives 0. table over one octant, about 1 unit (0.0055 deg) worst case
+uint16_t FxAtan2(Fixed y, Fixed x);
+
+// floor(sqrt(v)), bit by bit
+uint32_t FxSqrt64(uint64_t v);
+
+// length of (x, y), 16.16
+Fixed FxLength(Fixed x, Fixed y);
+
+// scale (x, y) to unit length in place with an integer inverse sqrt (table seed + two
+// Newton steps, no divides). false (and left alone) if it's zero
+bool FxNormalize(Fixed *x, Fixed *y);
+
+#endif
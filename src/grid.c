@@ -0,0 +1,134 @@
+// NULL TERMINATOR — uniform grid broadphase
+
+#include "grid.h"
+#include "mem.h"
+
+static int ClampI(int v, int lo, int hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// only ever used clamped to the grid: truncating instead of floorf (a libm call
+// without SSE4.1) only differs below zero, which clamps to 0 either way
+static int CellCoord(float v) {
+    return (int)((v + GRID_MARGIN) * (1.0f / GRID_CELL));
+}
+
+bool GridInit(BulletGrid *g, int capacity) {
+    g->items = NULL;
+    g->capacity = 0;
+    g->contacts = (GridContactList){ NULL, 0, 0, false };
+    g->blocks = NULL;
+    g->blockCapacity = 0;
+    g->contacts.items = MemAlloc(MEM_COLLISION, sizeof(GridContact) * GRID_CONTACT_RESERVE);
+    if (!g->contacts.items) return false;
+    g->contacts.capacity = GRID_CONTACT_RESERVE;
+    return GridReserve(g, capacity);
+}
+
+void GridFree(BulletGrid *g) {
+    MemFree(g->items);
+    g->items = g->cellOf = NULL;
+    g->itemX = g->itemY = g->itemVX = g->itemVY = g->itemT = NULL;
+    g->capacity = 0;
+    MemFree(g->contacts.items);
+    g->contacts = (GridContactList){ NULL, 0, 0, false };
+    for (int b = 0; b < g->blockCapacity; ++b) MemFree(g->blocks[b].items);
+    MemFree(g->blocks);
+    g->blocks = NULL;
+    g->blockCapacity = 0;
+}
+
+bool GridReserve(BulletGrid *g, int n) {
+    if (n <= g->capacity) return true;
+    int cap = g->capacity ? g->capacity : 256;
+    while (cap < n) cap *= 2;
+
+    // scratch only, nothing to keep: free + malloc instead of realloc
+    void *buf = MemAlloc(MEM_COLLISION, (sizeof(int) * 2 + sizeof(float) * 5) * (size_t)cap);
+    if (!buf) return false;
+    MemFree(g->items);
+    g->items   = buf;
+    g->cellOf  = g->items + cap;
+    g->itemX   = (float *)(g->cellOf + cap);
+    g->itemY   = g->itemX + cap;
+    g->itemVX  = g->itemY + cap;
+    g->itemVY  = g->itemVX + cap;
+    g->itemT   = g->itemVY + cap;
+    g->capacity = cap;
+    return true;
+}
+
+bool GridReserveBlocks(BulletGrid *g, int n) {
+    int blocks = (n + SIM_JOB_GRAIN - 1) / SIM_JOB_GRAIN;
+    if (blocks > g->blockCapacity) {
+        GridContactList *list = MemRealloc(MEM_COLLISION, g->blocks, sizeof(*list) * (size_t)blocks);
+        if (!list) return false;
+        for (int b = g->blockCapacity; b < blocks; ++b) list[b] = (GridContactList){ NULL, 0, 0, false };
+        g->blocks = list;
+        g->blockCapacity = blocks;
+    }
+    for (int b = 0; b < blocks; ++b) {
+        g->blocks[b].count = 0;
+        g->blocks[b].failed = false;
+    }
+    return true;
+}
+
+bool GridContactPush(GridContactList *l, GridContact c) {
+    if (l->count == l->capacity) {
+        int cap = l->capacity ? l->capacity * 2 : GRID_CONTACT_RESERVE;
+        GridContact *items = MemRealloc(MEM_COLLISION, l->items, sizeof(*items) * (size_t)cap);
+        if (!items) return false;
+        l->items = items;
+        l->capacity = cap;
+    }
+    l->items[l->count++] = c;
+    return true;
+}
+
+void GridBuild(BulletGrid *g, const EntityPool *p, float dt) {
+    int *start = g->cellStart;
+    for (int c = 0; c <= GRID_CELLS; ++c) start[c] = 0;
+    float half = dt * 0.5f;
+
+    // count per cell (shifted by one so the prefix sum lands on the start index)
+    for (int ch = 0; ch < POOL_USED_CHUNKS(p); ++ch) {
+        const PoolChunk *pc = p->chunks[ch];
+        int n = POOL_CHUNK_COUNT(p, ch);
+        int *cellOf = g->cellOf + (ch << POOL_CHUNK_SHIFT);
+        for (int i = 0; i < n; ++i) {
+            int cx = ClampI(CellCoord(pc->x[i] + pc->vx[i] * half), 0, GRID_COLS - 1);
+            int cy = ClampI(CellCoord(pc->y[i] + pc->vy[i] * half), 0, GRID_ROWS - 1);
+            int c = cy * GRID_COLS + cx;
+            cellOf[i] = c;
+            start[c + 1]++;
+        }
+    }
+    for (int c = 0; c < GRID_CELLS; ++c) start[c + 1] += start[c];
+
+    // scatter; cellStart[c] walks forward while filling, then gets shifted back one cell
+    for (int ch = 0; ch < POOL_USED_CHUNKS(p); ++ch) {
+        const PoolChunk *pc = p->chunks[ch];
+        int n = POOL_CHUNK_COUNT(p, ch), base = ch << POOL_CHUNK_SHIFT;
+        for (int i = 0; i < n; ++i) {
+            int k = start[g->cellOf[base + i]]++;
+            g->items[k] = base + i;
+            g->itemX[k] = pc->x[i];
+            g->itemY[k] = pc->y[i];
+            g->itemVX[k] = pc->vx[i];
+            g->itemVY[k] = pc->vy[i];
+            g->itemT[k] = pc->life[i] < dt ? pc->life[i] : dt;
+        }
+    }
+    for (int c = GRID_CELLS; c > 0; --c) start[c] = start[c - 1];
+    start[0] = 0;
+}
+
+void GridQueryRange(float x, float y, float reach, int *cx0, int *cy0, int *cx1, int *cy1) {
+    // clamping is monotonic: a point whose own cell was clamped into an edge cell is
+    // still inside the clamped range
+    *cx0 = ClampI(CellCoord(x - reach), 0, GRID_COLS - 1);
+    *cy0 = ClampI(CellCoord(y - reach), 0, GRID_ROWS - 1);
+    *cx1 = ClampI(CellCoord(x + reach), 0, GRID_COLS - 1);
+    *cy1 = ClampI(CellCoord(y + reach), 0, GRID_ROWS - 1);
+}
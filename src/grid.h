@@ -0,0 +1,80 @@
+// NULL TERMINATOR — uniform grid broadphase
+// Bucket bullets into fixed-size cells once per tick (counting sort, no allocation),
+// then each enemy only looks at the few cells its step can reach instead of every bullet.
+
+#ifndef NT_GRID_H
+#define NT_GRID_H
+
+#include "tuning.h"
+#include "pool.h"
+#include <stdbool.h>
+
+// about the kill distance (ENEMY_RADIUS + BULLET_RADIUS is 11); a query also reaches
+// half of both steps further, see GridQueryRange
+#define GRID_CELL_PX   12
+#define GRID_MARGIN_PX 20    // bullets get culled 20px past the screen edge
+#define GRID_CELL   ((float)GRID_CELL_PX)
+#define GRID_MARGIN ((float)GRID_MARGIN_PX)
+#define GRID_COLS   ((SCREEN_W + 2 * GRID_MARGIN_PX) / GRID_CELL_PX + 1)
+#define GRID_ROWS   ((SCREEN_H + 2 * GRID_MARGIN_PX) / GRID_CELL_PX + 1)
+#define GRID_CELLS  (GRID_COLS * GRID_ROWS)
+
+// below this many enemy*bullet pairs the plain double loop wins (grid build is ~4k cells)
+#define GRID_MIN_PAIRS 4096
+
+// contacts the collision pass has room for up front (a tick in normal play has a few)
+#define GRID_CONTACT_RESERVE 1024
+
+// a bullet that reaches an enemy during the step: how far in (seconds) and which two,
+// as indices when the collision pass started
+typedef struct {
+    float t;
+    int enemy, bullet;
+} GridContact;
+
+// contacts found for one block of SIM_JOB_GRAIN enemies (filled by a job thread), or
+// for the whole pass
+typedef struct {
+    GridContact *items;
+    int count, capacity;
+    bool failed;             // ran out of memory partway, the block has to be queried again
+} GridContactList;
+
+typedef struct {
+    int cellStart[GRID_CELLS + 1];   // items[cellStart[c] .. cellStart[c+1]) are in cell c
+    int *items;                      // point ids (pool index at build time), sorted by cell
+    float *itemX, *itemY;            // their positions in the same order (queries read these straight through)
+    float *itemVX, *itemVY;          // and velocities
+    float *itemT;                    // and how long they move this step: min(life, dt)
+    int *cellOf;                     // scratch: cell of each id during build (the collision pass reuses it after)
+    int capacity;
+
+    // what the collision pass found (see SimCollideBullets): everything ends up in
+    // contacts; with job threads each block of enemies fills its own list first
+    GridContactList contacts;
+    GridContactList *blocks;
+    int blockCapacity;
+} BulletGrid;
+
+bool GridInit(BulletGrid *g, int capacity);
+void GridFree(BulletGrid *g);
+
+// room for n points; only allocates when the bullet pool hits a new high
+bool GridReserve(BulletGrid *g, int n);
+
+// one contact list per SIM_JOB_GRAIN block of n enemies, all of them emptied
+bool GridReserveBlocks(BulletGrid *g, int n);
+
+// append (grows, the memory stays for next tick), false if out of memory
+bool GridContactPush(GridContactList *l, GridContact c);
+
+// bucket every bullet in the pool by the middle of its next step (position + velocity *
+// dt / 2); id == its index at build time. anything outside the bullet cull box lands in
+// an edge cell
+void GridBuild(BulletGrid *g, const EntityPool *p, float dt);
+
+// inclusive cell range holding every point bucketed within `reach` of (x, y), clamped
+// to the grid the same way GridBuild clamps, so it's never empty
+void GridQueryRange(float x, float y, float reach, int *cx0, int *cy0, int *cx1, int *cy1);
+
+#endif
@@ -0,0 +1,106 @@
+// NULL TERMINATOR — timestamped input
+
+#define _POSIX_C_SOURCE 200112L
+#include "input.h"
+#include "mem.h"
+#include <string.h>
+#include <time.h>
+
+uint64_t InputNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void InputQueueInit(InputQueue *q) {
+    memset(q, 0, sizeof(*q));
+}
+
+bool InputQueuePush(InputQueue *q, const InputSample *in) {
+    uint32_t head = q->head;
+    if (head - __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE) >= INPUT_QUEUE_SIZE) {
+        q->dropped++;
+        return false;
+    }
+    q->items[head & (INPUT_QUEUE_SIZE - 1)] = *in;
+    __atomic_store_n(&q->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool InputQueuePeek(InputQueue *q, InputSample *out) {
+    uint32_t tail = q->tail;
+    if (tail == __atomic_load_n(&q->head, __ATOMIC_ACQUIRE)) return false;
+    *out = q->items[tail & (INPUT_QUEUE_SIZE - 1)];
+    return true;
+}
+
+void InputQueuePop(InputQueue *q) {
+    __atomic_store_n(&q->tail, q->tail + 1, __ATOMIC_RELEASE);
+}
+
+static void *InputThreadMain(void *arg) {
+    InputThread *t = arg;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (!__atomic_load_n(&t->quit, __ATOMIC_ACQUIRE)) {
+        InputSample s = {0};
+        s.t = InputNow();
+        if (t->poll(t->user, &s)) InputQueuePush(t->q, &s);
+        t->polls++;
+
+        // absolute deadlines, so a late wakeup doesn't push every later poll back
+        next.tv_nsec += (long)t->period;
+        while (next.tv_nsec >= 1000000000L) { next.tv_nsec -= 1000000000L; next.tv_sec++; }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+    return NULL;
+}
+
+bool InputThreadStart(InputThread *t, InputQueue *q, int hz, InputSourceFn poll, void *user) {
+    if (hz < 1) hz = 1;
+    t->q = q;
+    t->poll = poll;
+    t->user = user;
+    t->period = 1000000000ull / (uint64_t)hz;
+    t->quit = 0;
+    t->polls = 0;
+    t->running = pthread_create(&t->thread, NULL, InputThreadMain, t) == 0;
+    if (t->running) MemNoteHeld(MEM_IO, sizeof(*q));      // the ring it fills
+    return t->running;
+}
+
+void InputThreadStop(InputThread *t) {
+    if (!t->running) return;
+    __atomic_store_n(&t->quit, 1, __ATOMIC_RELEASE);
+    pthread_join(t->thread, NULL);
+    t->running = false;
+    MemNoteHeld(MEM_IO, -(int64_t)sizeof(*t->q));
+}
+
+void InputReaderInit(InputReader *r, InputQueue *q) {
+    memset(r, 0, sizeof(*r));
+    r->q = q;
+}
+
+void InputReaderNext(void *user, float behind, SimInput *out) {
+    InputReader *r = user;
+    uint64_t back = (uint64_t)(behind * 1e9f);
+    uint64_t end = r->now > back ? r->now - back : 0;
+
+    SimInput in = { r->held.aim, r->held.fire, false };
+    bool pressed = false;
+    InputSample s;
+    while (InputQueuePeek(r->q, &s) && s.t <= end) {
+        InputQueuePop(r->q);
+        if (s.fire && !r->held.fire && !pressed) {
+            in.aim = s.aim;           // the shot goes where the click was
+            pressed = true;
+        }
+        in.fire = in.fire || s.fire;
+        in.restart = in.restart || s.restart;
+        r->held = s;
+        r->taken++;
+    }
+    if (!pressed) in.aim = r->held.aim;
+    *out = in;
+}
@@ -0,0 +1,85 @@
+// NULL TERMINATOR — timestamped input
+// Input sampled off the frame clock: a producer thread polls a source at up to 1000 Hz
+// and pushes timestamped samples into a single-producer single-consumer ring. Each frame
+// the sim side hands every tick the samples that fall inside it (SimAdvanceEach +
+// InputReaderNext), so a click fires on the tick it happened in, at the aim it had
+// then, and a tap that's released before the next frame still fires.
+//
+// raylib only polls the OS on the main thread once per frame, so the window build can't
+// sample faster than it draws; the thread is for sources that can (headless synthetic
+// input, see `bin/headless --input-test`).
+
+#ifndef NT_INPUT_H
+#define NT_INPUT_H
+
+#include "sim.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    uint64_t t;          // ns, InputNow clock
+    Vec2 aim;
+    bool fire;           // held
+    bool restart;        // pressed since the last sample
+} InputSample;
+
+#define INPUT_QUEUE_SIZE 4096     // power of two, 4 s of samples at 1000 Hz
+
+// head is only written by the producer, tail only by the consumer, each on its own
+// cache line so they don't fight over it
+typedef struct {
+    uint32_t head;
+    uint32_t dropped;             // pushes that found the ring full
+    char pad0[56];
+    uint32_t tail;
+    char pad1[60];
+    InputSample items[INPUT_QUEUE_SIZE];
+} InputQueue;
+
+uint64_t InputNow(void);          // monotonic ns
+
+void InputQueueInit(InputQueue *q);
+
+// producer side. false (and counted in dropped) if the consumer is a whole ring behind
+bool InputQueuePush(InputQueue *q, const InputSample *in);
+
+// consumer side: the oldest sample without taking it, then taking it
+bool InputQueuePeek(InputQueue *q, InputSample *out);
+void InputQueuePop(InputQueue *q);
+
+// fills *out with the source's current state (t is stamped by the thread).
+// return false when nothing changed, so only changes take up the ring
+typedef bool (*InputSourceFn)(void *user, InputSample *out);
+
+typedef struct {
+    pthread_t thread;
+    InputQueue *q;
+    InputSourceFn poll;
+    void *user;
+    uint64_t period;              // ns between polls
+    int quit;
+    bool running;
+    uint64_t polls;               // read after stop
+} InputThread;
+
+bool InputThreadStart(InputThread *t, InputQueue *q, int hz, InputSourceFn poll, void *user);
+void InputThreadStop(InputThread *t);
+
+// consumer state between frames. set `now` to the time the frame's ticks end at
+// (InputNow() right before SimAdvanceEach), then pass InputReaderNext as its SimInputFn
+typedef struct {
+    InputQueue *q;
+    uint64_t now;
+    InputSample held;             // newest sample taken, stands until the next one
+    uint64_t taken;
+} InputReader;
+
+void InputReaderInit(InputReader *r, InputQueue *q);
+
+// every sample up to the tick's end goes into it: fire if fire was held at any point,
+// restart if one was pressed, and the aim is where the crosshair was when fire went
+// down (the newest aim otherwise)
+void InputReaderNext(void *user, float behind, SimInput *out);
+
+#endif
@@ -0,0 +1,149 @@
+// NULL TERMINATOR — job system
+
+#define _POSIX_C_SOURCE 200112L
+#include "jobs.h"
+#include <unistd.h>
+
+// own deque, newest first (still warm in cache)
+static bool PopTask(JobDeque *q, JobTask *out) {
+    bool got = false;
+    pthread_mutex_lock(&q->lock);
+    if (q->tail > q->head) {
+        *out = q->tasks[--q->tail];
+        got = true;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return got;
+}
+
+// someone else's deque, oldest first (furthest from what its owner is touching)
+static bool StealTask(JobDeque *q, JobTask *out) {
+    bool got = false;
+    pthread_mutex_lock(&q->lock);
+    if (q->tail > q->head) {
+        *out = q->tasks[q->head++];
+        got = true;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return got;
+}
+
+static bool TakeTask(JobSystem *js, int self, JobTask *out) {
+    if (PopTask(&js->queues[self], out)) return true;
+    for (int k = 1; k < js->threadCount; ++k) {
+        if (StealTask(&js->queues[(self + k) % js->threadCount], out)) return true;
+    }
+    return false;
+}
+
+static void RunTasks(JobSystem *js, int self) {
+    JobTask t;
+    while (TakeTask(js, self, &t)) {
+        t.fn(t.user, t.begin, t.end);
+        if (__atomic_sub_fetch(&js->pending, 1, __ATOMIC_ACQ_REL) == 0) {
+            pthread_mutex_lock(&js->lock);
+            pthread_cond_signal(&js->done);
+            pthread_mutex_unlock(&js->lock);
+        }
+    }
+}
+
+static void *WorkerMain(void *arg) {
+    JobSystem *js = ((JobDeque *)arg)->owner;
+    int self = ((JobDeque *)arg)->index;
+    unsigned seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&js->lock);
+        while (js->batch == seen && !js->quit) pthread_cond_wait(&js->wake, &js->lock);
+        bool quit = js->quit;
+        seen = js->batch;
+        pthread_mutex_unlock(&js->lock);
+        if (quit) break;
+        RunTasks(js, self);
+    }
+    return NULL;
+}
+
+bool JobsInit(JobSystem *js, int threads) {
+    if (threads < 1) threads = 1;
+    if (threads > JOBS_MAX_THREADS) threads = JOBS_MAX_THREADS;
+    js->threadCount = 1;
+    js->batch = 0;
+    js->quit = false;
+    js->pending = 0;
+    pthread_mutex_init(&js->lock, NULL);
+    pthread_cond_init(&js->wake, NULL);
+    pthread_cond_init(&js->done, NULL);
+    for (int i = 0; i < threads; ++i) {
+        pthread_mutex_init(&js->queues[i].lock, NULL);
+        js->queues[i].head = js->queues[i].tail = 0;
+        js->queues[i].owner = js;
+        js->queues[i].index = i;
+    }
+
+    // thread 0 is the caller
+    for (int i = 1; i < threads; ++i) {
+        if (pthread_create(&js->threads[i], NULL, WorkerMain, &js->queues[i]) != 0) {
+            JobsShutdown(js);
+            return false;
+        }
+        js->threadCount++;
+    }
+    return true;
+}
+
+void JobsShutdown(JobSystem *js) {
+    pthread_mutex_lock(&js->lock);
+    js->quit = true;
+    pthread_cond_broadcast(&js->wake);
+    pthread_mutex_unlock(&js->lock);
+    for (int i = 1; i < js->threadCount; ++i) pthread_join(js->threads[i], NULL);
+    js->threadCount = 1;
+}
+
+int JobsCpuCount(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) return 1;
+    return n > JOBS_MAX_THREADS ? JOBS_MAX_THREADS : (int)n;
+}
+
+void JobsParallelFor(JobSystem *js, int count, int grain, JobFn fn, void *user) {
+    if (count <= 0) return;
+    if (grain < 1) grain = 1;
+    if (!js || js->threadCount == 1 || count <= grain) {
+        fn(user, 0, count);
+        return;
+    }
+
+    int n = js->threadCount;
+    int tasks = (count + grain - 1) / grain;
+    if (tasks > JOBS_MAX_TASKS) {
+        tasks = JOBS_MAX_TASKS;
+        grain = (count + tasks - 1) / tasks;
+        tasks = (count + grain - 1) / grain;
+    }
+
+    // deal ranges out round-robin; a worker still finishing the last batch only
+    // ever finds empty deques, so refilling here is safe
+    __atomic_store_n(&js->pending, tasks, __ATOMIC_RELEASE);
+    for (int i = 0; i < n; ++i) pthread_mutex_lock(&js->queues[i].lock);
+    for (int i = 0; i < n; ++i) js->queues[i].head = js->queues[i].tail = 0;
+    for (int t = 0; t < tasks; ++t) {
+        int begin = t * grain;
+        int end = begin + grain < count ? begin + grain : count;
+        JobDeque *q = &js->queues[t % n];
+        q->tasks[q->tail++] = (JobTask){ fn, user, begin, end };
+    }
+    for (int i = n - 1; i >= 0; --i) pthread_mutex_unlock(&js->queues[i].lock);
+
+    pthread_mutex_lock(&js->lock);
+    js->batch++;
+    pthread_cond_broadcast(&js->wake);
+    pthread_mutex_unlock(&js->lock);
+
+    RunTasks(js, 0);
+
+    pthread_mutex_lock(&js->lock);
+    while (__atomic_load_n(&js->pending, __ATOMIC_ACQUIRE) > 0) pthread_cond_wait(&js->done, &js->lock);
+    pthread_mutex_unlock(&js->lock);
+}
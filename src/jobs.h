@@ -0,0 +1,62 @@
+// NULL TERMINATOR — job system
+// Small thread pool for splitting the per-tick loops across cores.
+// Each thread owns a deque of index ranges: it pops its own from the back and,
+// once empty, steals from the front of the others, so a slow chunk doesn't
+// leave the rest of the threads idle.
+//
+// Only one thread (the one running the sim) hands out work, and JobsParallelFor
+// blocks until every range is done. Jobs can't start more jobs.
+// Results must not depend on which thread ran what: write to per-index slots
+// or merge afterwards in index order (see SimCollideBullets).
+
+#ifndef NT_JOBS_H
+#define NT_JOBS_H
+
+#include <pthread.h>
+#include <stdbool.h>
+
+#define JOBS_MAX_THREADS 64
+#define JOBS_MAX_TASKS   256     // ranges per ParallelFor, per thread deque
+
+// run fn over [begin, end) of the index space
+typedef void (*JobFn)(void *user, int begin, int end);
+
+typedef struct {
+    JobFn fn;
+    void *user;
+    int begin, end;
+} JobTask;
+
+typedef struct {
+    pthread_mutex_t lock;
+    JobTask tasks[JOBS_MAX_TASKS];
+    int head, tail;              // live tasks are tasks[head .. tail)
+    struct JobSystem *owner;     // so a worker thread knows where it lives
+    int index;
+} JobDeque;
+
+typedef struct JobSystem {
+    int threadCount;             // including the caller
+    pthread_t threads[JOBS_MAX_THREADS];
+    JobDeque queues[JOBS_MAX_THREADS];
+
+    pthread_mutex_t lock;        // guards the two fields below and the condvars
+    pthread_cond_t wake, done;
+    unsigned batch;              // bumped every ParallelFor, wakes the workers
+    bool quit;
+    int pending;                 // tasks not finished yet (atomic)
+} JobSystem;
+
+// threads counts the caller, so 1 means no extra threads (everything runs inline).
+// clamped to [1, JOBS_MAX_THREADS]. false if the threads couldn't be started
+bool JobsInit(JobSystem *js, int threads);
+void JobsShutdown(JobSystem *js);
+
+// online cores, for the default thread count
+int JobsCpuCount(void);
+
+// fn over [0, count) in ranges of about `grain`, spread over all threads, returns
+// when all of it is done. js may be NULL (runs inline)
+void JobsParallelFor(JobSystem *js, int count, int grain, JobFn fn, void *user);
+
+#endif
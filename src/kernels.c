@@ -0,0 +1,223 @@
+// NULL TERMINATOR — SIMD kernels
+
+#include "kernels.h"
+#include <math.h>
+
+#if !defined(NT_NO_SIMD) && defined(__AVX__)
+  #include <immintrin.h>
+  #define K_WIDTH 8
+  typedef __m256 vf;
+  #define VLOAD(p)      _mm256_loadu_ps(p)
+  #define VSTORE(p, v)  _mm256_storeu_ps(p, v)
+  #define VSET1(s)      _mm256_set1_ps(s)
+  #define VADD(a, b)    _mm256_add_ps(a, b)
+  #define VSUB(a, b)    _mm256_sub_ps(a, b)
+  #define VMUL(a, b)    _mm256_mul_ps(a, b)
+  #define VDIV(a, b)    _mm256_div_ps(a, b)
+  #define VSQRT(a)      _mm256_sqrt_ps(a)
+  #define VAND(a, b)    _mm256_and_ps(a, b)
+  #define VOR(a, b)     _mm256_or_ps(a, b)
+  #define VLT(a, b)     _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+  #define VGT(a, b)     _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+  #define VLE(a, b)     _mm256_cmp_ps(a, b, _CMP_LE_OQ)
+  #define VMASK(v)      _mm256_movemask_ps(v)
+  #define VMIN(a, b)    _mm256_min_ps(a, b)
+  #define VMAX(a, b)    _mm256_max_ps(a, b)
+#elif !defined(NT_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+  #include <emmintrin.h>
+  #define K_WIDTH 4
+  typedef __m128 vf;
+  #define VLOAD(p)      _mm_loadu_ps(p)
+  #define VSTORE(p, v)  _mm_storeu_ps(p, v)
+  #define VSET1(s)      _mm_set1_ps(s)
+  #define VADD(a, b)    _mm_add_ps(a, b)
+  #define VSUB(a, b)    _mm_sub_ps(a, b)
+  #define VMUL(a, b)    _mm_mul_ps(a, b)
+  #define VDIV(a, b)    _mm_div_ps(a, b)
+  #define VSQRT(a)      _mm_sqrt_ps(a)
+  #define VAND(a, b)    _mm_and_ps(a, b)
+  #define VOR(a, b)     _mm_or_ps(a, b)
+  #define VLT(a, b)     _mm_cmplt_ps(a, b)
+  #define VGT(a, b)     _mm_cmpgt_ps(a, b)
+  #define VLE(a, b)     _mm_cmple_ps(a, b)
+  #define VMASK(v)      _mm_movemask_ps(v)
+  #define VMIN(a, b)    _mm_min_ps(a, b)
+  #define VMAX(a, b)    _mm_max_ps(a, b)
+#else
+  #define K_WIDTH 1
+#endif
+
+
+void KernelIntegrate(float *x, float *y, const float *vx, const float *vy, int n, float dt) {
+    int i = 0;
+#if K_WIDTH > 1
+    vf vdt = VSET1(dt);
+    for (; i + K_WIDTH <= n; i += K_WIDTH) {
+        VSTORE(x + i, VADD(VLOAD(x + i), VMUL(VLOAD(vx + i), vdt)));
+        VSTORE(y + i, VADD(VLOAD(y + i), VMUL(VLOAD(vy + i), vdt)));
+    }
+#endif
+    for (; i < n; ++i) {
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+    }
+}
+
+void KernelAge(float *life, int n, float dt) {
+    int i = 0;
+#if K_WIDTH > 1
+    vf vdt = VSET1(dt);
+    for (; i + K_WIDTH <= n; i += K_WIDTH) VSTORE(life + i, VSUB(VLOAD(life + i), vdt));
+#endif
+    for (; i < n; ++i) life[i] -= dt;
+}
+
+void KernelScale2(float *vx, float *vy, int n, float f) {
+    int i = 0;
+#if K_WIDTH > 1
+    vf vscale = VSET1(f);
+    for (; i + K_WIDTH <= n; i += K_WIDTH) {
+        VSTORE(vx + i, VMUL(VLOAD(vx + i), vscale));
+        VSTORE(vy + i, VMUL(VLOAD(vy + i), vscale));
+    }
+#endif
+    for (; i < n; ++i) {
+        vx[i] *= f;
+        vy[i] *= f;
+    }
+}
+
+void KernelAimAt(const float *x, const float *y, float *vx, float *vy, int n,
+                 float tx, float ty, float speed) {
+    int i = 0;
+#if K_WIDTH > 1
+    vf vtx = VSET1(tx), vty = VSET1(ty), vspeed = VSET1(speed), vmin = VSET1(0.0001f);
+    for (; i + K_WIDTH <= n; i += K_WIDTH) {
+        vf dx = VSUB(vtx, VLOAD(x + i)), dy = VSUB(vty, VLOAD(y + i));
+        vf len = VSQRT(VADD(VMUL(dx, dx), VMUL(dy, dy)));
+        vf far = VGT(len, vmin);           // too close: the division is garbage, mask it to 0
+        VSTORE(vx + i, VAND(far, VMUL(VDIV(dx, len), vspeed)));
+        VSTORE(vy + i, VAND(far, VMUL(VDIV(dy, len), vspeed)));
+    }
+#endif
+    for (; i < n; ++i) {
+        float dx = tx - x[i], dy = ty - y[i];
+        float len = sqrtf(dx*dx + dy*dy);
+        if (len > 0.0001f) {
+            vx[i] = (dx / len) * speed;
+            vy[i] = (dy / len) * speed;
+        } else {
+            vx[i] = vy[i] = 0.0f;
+        }
+    }
+}
+
+#if K_WIDTH > 1
+// writes one byte per lane from a movemask, returns the popcount
+static int WriteMask(unsigned char *out, int bits, int lanes) {
+    int count = 0;
+    for (int l = 0; l < lanes; ++l) {
+        out[l] = (unsigned char)((bits >> l) & 1);
+        count += out[l];
+    }
+    return count;
+}
+#endif
+
+int KernelCullMask(const float *x, const float *y, const float *life, int n,
+                   float minX, float minY, float maxX, float maxY, unsigned char *dead) {
+    int i = 0, count = 0;
+#if K_WIDTH > 1
+    vf lo_x = VSET1(minX), lo_y = VSET1(minY), hi_x = VSET1(maxX), hi_y = VSET1(maxY);
+    vf zero = VSET1(0.0f);
+    for (; i + K_WIDTH <= n; i += K_WIDTH) {
+        vf px = VLOAD(x + i), py = VLOAD(y + i);
+        vf out = VOR(VOR(VLT(px, lo_x), VGT(px, hi_x)), VOR(VLT(py, lo_y), VGT(py, hi_y)));
+        if (life) out = VOR(out, VLE(VLOAD(life + i), zero));
+        int bits = VMASK(out);
+        if (bits) count += WriteMask(dead + i, bits, K_WIDTH);
+        else for (int l = 0; l < K_WIDTH; ++l) dead[i + l] = 0;
+    }
+#endif
+    for (; i < n; ++i) {
+        int out = x[i] < minX || x[i] > maxX || y[i] < minY || y[i] > maxY ||
+                  (life && life[i] <= 0.0f);
+        dead[i] = (unsigned char)out;
+        count += out;
+    }
+    return count;
+}
+
+int KernelWithin(const float *x, const float *y, int n, float px, float py, float r2,
+                 unsigned char *hit) {
+    int i = 0, count = 0;
+#if K_WIDTH > 1
+    vf cx = VSET1(px), cy = VSET1(py), vr2 = VSET1(r2);
+    for (; i + K_WIDTH <= n; i += K_WIDTH) {
+        vf dx = VSUB(VLOAD(x + i), cx), dy = VSUB(VLOAD(y + i), cy);
+        int bits = VMASK(VLE(VADD(VMUL(dx, dx), VMUL(dy, dy)), vr2));
+        if (bits) count += WriteMask(hit + i, bits, K_WIDTH);
+        else for (int l = 0; l < K_WIDTH; ++l) hit[i + l] = 0;
+    }
+#endif
+    for (; i < n; ++i) {
+        float dx = x[i] - px, dy = y[i] - py;
+        int in = dx*dx + dy*dy <= r2;
+        hit[i] = (unsigned char)in;
+        count += in;
+    }
+    return count;
+}
+
+int KernelSwept(const float *x, const float *y, const float *vx, const float *vy, const float *life,
+                int n, float px, float py, float pvx, float pvy, float dt, float r2, unsigned char *hit) {
+    int i = 0, count = 0;
+#if K_WIDTH > 1
+    vf cx = VSET1(px), cy = VSET1(py), cvx = VSET1(pvx), cvy = VSET1(pvy);
+    vf vdt = VSET1(dt), vr2 = VSET1(r2), zero = VSET1(0.0f);
+    for (; i + K_WIDTH <= n; i += K_WIDTH) {
+        vf t = VMIN(VLOAD(life + i), vdt);
+        vf dx = VSUB(VLOAD(x + i), cx), dy = VSUB(VLOAD(y + i), cy);
+        vf wx = VMUL(VSUB(VLOAD(vx + i), cvx), t), wy = VMUL(VSUB(VLOAD(vy + i), cvy), t);
+        vf dd = VADD(VMUL(dx, dx), VMUL(dy, dy));
+        vf dw = VADD(VMUL(dx, wx), VMUL(dy, wy));
+        vf ww = VADD(VMUL(wx, wx), VMUL(wy, wy));
+        vf ex = VADD(dx, wx), ey = VADD(dy, wy);
+        vf ends = VOR(VLE(dd, vr2), VLE(VADD(VMUL(ex, ex), VMUL(ey, ey)), vr2));
+        vf mid = VAND(VAND(VLT(dw, zero), VLT(VSUB(zero, dw), ww)),
+                      VLE(VSUB(VMUL(dd, ww), VMUL(dw, dw)), VMUL(vr2, ww)));
+        int bits = VMASK(VOR(ends, mid));
+        if (bits) count += WriteMask(hit + i, bits, K_WIDTH);
+        else for (int l = 0; l < K_WIDTH; ++l) hit[i + l] = 0;
+    }
+#endif
+    for (; i < n; ++i) {
+        float t = life[i] < dt ? life[i] : dt;
+        int in = SweptWithin(x[i] - px, y[i] - py, (vx[i] - pvx) * t, (vy[i] - pvy) * t, r2);
+        hit[i] = (unsigned char)in;
+        count += in;
+    }
+    return count;
+}
+
+float KernelMaxLen2(const float *vx, const float *vy, int n) {
+    int i = 0;
+    float best = 0.0f;
+#if K_WIDTH > 1
+    if (n >= K_WIDTH) {
+        vf m = VSET1(0.0f);
+        for (; i + K_WIDTH <= n; i += K_WIDTH) {
+            vf x = VLOAD(vx + i), y = VLOAD(vy + i);
+            m = VMAX(m, VADD(VMUL(x, x), VMUL(y, y)));
+        }
+        float lanes[K_WIDTH];
+        VSTORE(lanes, m);
+        for (int l = 0; l < K_WIDTH; ++l) if (lanes[l] > best) best = lanes[l];
+    }
+#endif
+    for (; i < n; ++i) {
+        float l2 = vx[i]*vx[i] + vy[i]*vy[i];
+        if (l2 > best) best = l2;
+    }
+    return best;
+}
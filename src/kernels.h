@@ -0,0 +1,67 @@
+// NULL TERMINATOR — SIMD kernels
+// Tight loops over plain float arrays (structure-of-arrays entity pools).
+// AVX when built with -mavx (make SIMD=avx), SSE2 on any x86-64, scalar everywhere else
+// or with -DNT_NO_SIMD. Every path does the same float ops in the same order, so
+// results are bit-identical to the scalar code (no FMA, no reassociation).
+
+#ifndef NT_KERNELS_H
+#define NT_KERNELS_H
+
+#include <math.h>
+
+// pool arrays are allocated on this boundary (one AVX register)
+#define KERNEL_ALIGN 32
+
+// x += vx*dt, y += vy*dt for [0, n)
+void KernelIntegrate(float *x, float *y, const float *vx, const float *vy, int n, float dt);
+
+// life -= dt for [0, n)
+void KernelAge(float *life, int n, float dt);
+
+// vx *= f, vy *= f for [0, n)
+void KernelScale2(float *vx, float *vy, int n, float f);
+
+// vx, vy = speed * the unit vector from (x, y) toward (tx, ty) for [0, n), zero when
+// closer than 0.0001 (sqrt and divide are exact in SIMD too, so same bits)
+void KernelAimAt(const float *x, const float *y, float *vx, float *vy, int n,
+                 float tx, float ty, float speed);
+
+// dead[i] = 1 if (x, y) is outside [minX, maxX] x [minY, maxY] or (life && life[i] <= 0),
+// else 0. returns how many are dead
+int KernelCullMask(const float *x, const float *y, const float *life, int n,
+                   float minX, float minY, float maxX, float maxY, unsigned char *dead);
+
+// hit[i] = 1 if (x[i]-px)^2 + (y[i]-py)^2 <= r2, returns how many hit
+int KernelWithin(const float *x, const float *y, int n, float px, float py, float r2,
+                 unsigned char *hit);
+
+// swept test: a point (dx, dy) from a circle's center that moves (wx, wy) relative to it
+// over the step, does it come within sqrt(r2) anywhere along the way? closest approach
+// without a divide. the scalar form of KernelSwept, the grid queries use it too so
+// both agree bit for bit
+static inline int SweptWithin(float dx, float dy, float wx, float wy, float r2) {
+    float dd = dx*dx + dy*dy, dw = dx*wx + dy*wy, ww = wx*wx + wy*wy;
+    float ex = dx + wx, ey = dy + wy;
+    return dd <= r2 || ex*ex + ey*ey <= r2 || (dw < 0.0f && -dw < ww && dd*ww - dw*dw <= r2*ww);
+}
+
+// for a SweptWithin hit: how far into the step (0..1) it first touches
+static inline float SweptEntry(float dx, float dy, float wx, float wy, float r2) {
+    float dd = dx*dx + dy*dy;
+    if (dd <= r2) return 0.0f;
+    float dw = dx*wx + dy*wy, ww = wx*wx + wy*wy;
+    float disc = dw*dw - ww*(dd - r2);
+    float t = (-dw - sqrtf(disc > 0.0f ? disc : 0.0f)) / ww;
+    return t > 0.0f ? (t < 1.0f ? t : 1.0f) : 0.0f;     // never -0
+}
+
+// hit[i] = 1 if point i passes within sqrt(r2) of a circle at (px, py) moving at
+// (pvx, pvy) while both move for min(life[i], dt) (a bullet that expires mid-step only
+// counts up to then), returns how many hit
+int KernelSwept(const float *x, const float *y, const float *vx, const float *vy, const float *life,
+                int n, float px, float py, float pvx, float pvy, float dt, float r2, unsigned char *hit);
+
+// largest vx^2 + vy^2 over [0, n), 0 when n == 0
+float KernelMaxLen2(const float *vx, const float *vy, int n);
+
+#endif
@@ -0,0 +1,127 @@
+// NULL TERMINATOR — allocation counters
+
+#include "mem.h"
+#include <stdbool.h>
+#include <stdlib.h>
+
+// padded so the block keeps malloc's alignment (no max_align_t in C99)
+typedef union {
+    struct {
+        size_t size;
+        int tag;
+    } info;
+    long double ld;
+    long long ll;
+    void *ptr;
+} MemHeader;
+
+// updated from job threads too (grid contact lists), so all atomic
+static MemStats total, perTag[MEM_TAG_COUNT];
+
+static const char *const tagNames[MEM_TAG_COUNT] = {
+#define MEM_TAG_NAME(tag, name) name,
+    MEM_TAGS(MEM_TAG_NAME)
+#undef MEM_TAG_NAME
+};
+
+static void AccountIn(MemStats *st, int64_t delta) {
+    int64_t now = __atomic_add_fetch(&st->bytes, delta, __ATOMIC_RELAXED);
+    int64_t peak = __atomic_load_n(&st->peakBytes, __ATOMIC_RELAXED);
+    while (now > peak &&
+           !__atomic_compare_exchange_n(&st->peakBytes, &peak, now, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+static void Account(int tag, int64_t delta) {
+    AccountIn(&total, delta);
+    AccountIn(&perTag[tag], delta);
+}
+
+static void CountAlloc(int tag) {
+    __atomic_add_fetch(&total.allocs, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&perTag[tag].allocs, 1, __ATOMIC_RELAXED);
+}
+
+static int CheckTag(MemTag tag) {
+    return (int)tag >= 0 && tag < MEM_TAG_COUNT ? (int)tag : MEM_OTHER;
+}
+
+void *MemAlloc(MemTag tag, size_t bytes) {
+    int t = CheckTag(tag);
+    MemHeader *h = malloc(sizeof(MemHeader) + bytes);
+    if (!h) return NULL;
+    h->info.size = bytes;
+    h->info.tag = t;
+    CountAlloc(t);
+    Account(t, (int64_t)bytes);
+    return h + 1;
+}
+
+void *MemRealloc(MemTag tag, void *p, size_t bytes) {
+    if (!p) return MemAlloc(tag, bytes);
+    int t = CheckTag(tag);
+    MemHeader *old = (MemHeader *)p - 1;
+    size_t oldSize = old->info.size;
+    int oldTag = old->info.tag;
+    MemHeader *h = realloc(old, sizeof(MemHeader) + bytes);
+    if (!h) return NULL;
+    h->info.size = bytes;
+    h->info.tag = t;
+    CountAlloc(t);
+    if (t == oldTag) {
+        Account(t, (int64_t)bytes - (int64_t)oldSize);
+    } else {
+        Account(oldTag, -(int64_t)oldSize);
+        Account(t, (int64_t)bytes);
+    }
+    return h + 1;
+}
+
+void MemFree(void *p) {
+    if (!p) return;
+    MemHeader *h = (MemHeader *)p - 1;
+    __atomic_add_fetch(&total.frees, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&perTag[h->info.tag].frees, 1, __ATOMIC_RELAXED);
+    Account(h->info.tag, -(int64_t)h->info.size);
+    free(h);
+}
+
+void MemNoteHeld(MemTag tag, int64_t bytes) {
+    Account(CheckTag(tag), bytes);
+}
+
+static MemStats Load(const MemStats *st) {
+    MemStats s;
+    s.allocs    = __atomic_load_n(&st->allocs, __ATOMIC_RELAXED);
+    s.frees     = __atomic_load_n(&st->frees, __ATOMIC_RELAXED);
+    s.bytes     = __atomic_load_n(&st->bytes, __ATOMIC_RELAXED);
+    s.peakBytes = __atomic_load_n(&st->peakBytes, __ATOMIC_RELAXED);
+    return s;
+}
+
+MemStats MemGetStats(void) {
+    return Load(&total);
+}
+
+MemStats MemGetTagStats(MemTag tag) {
+    return Load(&perTag[CheckTag(tag)]);
+}
+
+const char *MemTagName(MemTag tag) {
+    return tagNames[CheckTag(tag)];
+}
+
+static void ResetPeak(MemStats *st) {
+    __atomic_store_n(&st->peakBytes, __atomic_load_n(&st->bytes, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+}
+
+void MemResetPeak(void) {
+    ResetPeak(&total);
+    for (int t = 0; t < MEM_TAG_COUNT; ++t) ResetPeak(&perTag[t]);
+}
+
+MemCounts MemGetCounts(void) {
+    MemCounts c;
+    for (int t = 0; t < MEM_TAG_COUNT; ++t) c.allocs[t] = __atomic_load_n(&perTag[t].allocs, __ATOMIC_RELAXED);
+    return c;
+}
@@ -0,0 +1,62 @@
+// NULL TERMINATOR — allocation counters
+// Everything in src/ allocates through these, so the bench (and anyone else) can
+// see how many allocations a tick does and how much heap the sim holds.
+// Thin wrappers over malloc/realloc/free with the size kept in a small header.
+//
+// Every block is tagged with the subsystem it's for, and the counters are kept per tag
+// as well as in total. Memory a subsystem holds without allocating it (fixed buffers
+// inside a struct, GPU textures) is added with MemNoteHeld, so a tag shows its whole
+// footprint; that counts bytes, never allocations.
+
+#ifndef NT_MEM_H
+#define NT_MEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// X(tag, name)
+#define MEM_TAGS(X) \
+    X(MEM_POOLS,     "pools")      /* enemy + bullet chunks and handle tables */ \
+    X(MEM_TRACES,    "traces") \
+    X(MEM_COLLISION, "collision")  /* bullet grid and contact lists */ \
+    X(MEM_RENDER,    "render")     /* draw lists, atlas texture */ \
+    X(MEM_PARTICLES, "particles") \
+    X(MEM_TEXT,      "text")       /* baked HUD text layers */ \
+    X(MEM_IO,        "io")         /* telemetry buffers, score queue, replay files */ \
+    X(MEM_SNAPSHOT,  "snapshots") \
+    X(MEM_OTHER,     "other")      /* tools */
+
+typedef enum {
+#define MEM_TAG_ENUM(tag, name) tag,
+    MEM_TAGS(MEM_TAG_ENUM)
+#undef MEM_TAG_ENUM
+    MEM_TAG_COUNT
+} MemTag;
+
+typedef struct {
+    uint64_t allocs;         // MemAlloc + MemRealloc calls that succeeded
+    uint64_t frees;
+    int64_t  bytes;          // live right now
+    int64_t  peakBytes;      // most live at once since the last MemResetPeak
+} MemStats;
+
+void *MemAlloc(MemTag tag, size_t bytes);
+void *MemRealloc(MemTag tag, void *p, size_t bytes);   // p may be NULL. the block is tag's after
+void  MemFree(void *p);                                // p may be NULL
+
+// bytes tag holds that didn't come from here: + when it takes them, - when it lets go
+void MemNoteHeld(MemTag tag, int64_t bytes);
+
+MemStats MemGetStats(void);                 // every tag together
+MemStats MemGetTagStats(MemTag tag);
+const char *MemTagName(MemTag tag);
+void MemResetPeak(void);                    // peak = current, total and per tag
+
+// allocations so far per tag: two of these around a tick say who allocated in it
+typedef struct {
+    uint64_t allocs[MEM_TAG_COUNT];
+} MemCounts;
+
+MemCounts MemGetCounts(void);
+
+#endif
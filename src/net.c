@@ -0,0 +1,340 @@
+// NULL TERMINATOR — co-op over loopback UDP, with rollback
+
+#define _POSIX_C_SOURCE 200112L
+#include "net.h"
+#include "input.h"
+#include "prof.h"
+#include "telemetry.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define RING_MASK (NET_RING - 1)
+#define SNAP_MASK (NET_WINDOW - 1)
+#define NO_TICK   UINT32_MAX
+
+static void PutLE(unsigned char *p, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static uint64_t GetLE(const unsigned char *p, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+static struct sockaddr_in Loopback(uint16_t port) {
+    struct sockaddr_in a;
+    memset(&a, 0, sizeof(a));
+    a.sin_family = AF_INET;
+    a.sin_port = htons(port);
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return a;
+}
+
+bool NetLinkOpen(NetLink *l, uint16_t port, uint16_t peerPort) {
+    memset(l, 0, sizeof(*l));
+    l->peerPort = peerPort;
+    RngSeed(&l->rng, ((uint64_t)port << 16) | peerPort);
+
+    l->fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (l->fd < 0) return false;
+    struct sockaddr_in self = Loopback(port);
+    int flags = fcntl(l->fd, F_GETFL, 0);
+    if (bind(l->fd, (struct sockaddr *)&self, sizeof(self)) != 0 ||
+        flags < 0 || fcntl(l->fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+        close(l->fd);
+        l->fd = -1;
+        return false;
+    }
+    return true;
+}
+
+void NetLinkClose(NetLink *l) {
+    if (l->fd >= 0) close(l->fd);
+    l->fd = -1;
+}
+
+// everything in the outbox that's due by now goes out
+static void LinkFlush(NetLink *l) {
+    uint64_t now = InputNow();
+    struct sockaddr_in peer = Loopback(l->peerPort);
+    int kept = 0;
+    for (int i = 0; i < l->outCount; ++i) {
+        if (l->outbox[i].due > now) {
+            if (kept != i) l->outbox[kept] = l->outbox[i];
+            kept++;
+            continue;
+        }
+        sendto(l->fd, l->outbox[i].data, (size_t)l->outbox[i].len, 0, (struct sockaddr *)&peer, sizeof(peer));
+        l->sent++;
+    }
+    l->outCount = kept;
+}
+
+// send now, or after the made-up lag (+ jitter, so packets can arrive out of order)
+static void LinkSend(NetLink *l, const unsigned char *data, int len) {
+    if (l->lossPct > 0 && RngRange(&l->rng, 0, 99) < l->lossPct) {
+        l->lost++;
+        return;
+    }
+    if (l->outCount == NET_OUTBOX) LinkFlush(l);
+    if (l->outCount == NET_OUTBOX) { l->lost++; return; }
+
+    int ms = l->lagMs + (l->jitterMs > 0 ? RngRange(&l->rng, 0, l->jitterMs) : 0);
+    l->outbox[l->outCount].due = InputNow() + (uint64_t)ms * 1000000ull;
+    l->outbox[l->outCount].len = len;
+    memcpy(l->outbox[l->outCount].data, data, (size_t)len);
+    l->outCount++;
+    LinkFlush(l);
+}
+
+bool NetSessionInit(NetSession *ns, GameState *s, NetLink *link, int self, int delay, int hz) {
+    memset(ns, 0, sizeof(*ns));
+    if (delay < 0) delay = 0;
+    if (delay > NET_MAX_DELAY) delay = NET_MAX_DELAY;
+    ns->s = s;
+    ns->link = link;
+    ns->self = self;
+    ns->delay = delay;
+    ns->step = 1.0f / (float)(hz > 0 ? hz : SIM_TICK_HZ);
+    ns->maxTick = NO_TICK;
+    ns->rollbackFrom = NO_TICK;
+    ns->hashTick = NO_TICK;
+    ns->peerHashTick = NO_TICK;
+    ns->peerHashSeen = NO_TICK;
+    ns->overTick = NO_TICK;
+    ns->heard = link == NULL;
+
+    // our first `delay` ticks are nobody's input, we hold still (and send that, so the
+    // two sides don't have to agree on a delay)
+    ns->localUpTo = (uint32_t)delay;
+    for (int i = 0; i < NET_RING; ++i) ns->hashAt[i] = NO_TICK;
+
+    // one snapshot up front, so the ring's first saves don't all grow from nothing
+    if (!SnapshotSave(&ns->snap[0], s)) return false;
+    return true;
+}
+
+void NetSessionFree(NetSession *ns) {
+    for (int i = 0; i < NET_WINDOW; ++i) SnapshotFree(&ns->snap[i]);
+}
+
+// same input as far as the sim can tell: aim only matters while fire is held
+static bool SameInput(const SimInput *a, const SimInput *b) {
+    if (a->fire != b->fire || a->restart != b->restart) return false;
+    return !a->fire || (a->aim.x == b->aim.x && a->aim.y == b->aim.y);
+}
+
+void NetReceiveInputs(NetSession *ns, uint32_t first, int count, const SimInput *in) {
+    ns->heard = true;
+    for (int i = 0; i < count; ++i) {
+        uint32_t t = first + (uint32_t)i;
+        if (t < ns->remoteUpTo) continue;                 // had it already
+        if (t > ns->remoteUpTo || t >= ns->tick + NET_RING) break;   // gap, comes again later
+
+        SimInput *slot = &ns->remote[t & RING_MASK];
+        if (t < ns->tick && !SameInput(slot, &in[i]) && t < ns->rollbackFrom) ns->rollbackFrom = t;
+        *slot = in[i];
+        ns->remoteUpTo++;
+    }
+}
+
+bool NetSettled(const NetSession *ns, uint32_t tick) {
+    return ns->tick >= tick && ns->remoteUpTo >= tick && ns->rollbackFrom == NO_TICK;
+}
+
+// the peer's input for tick t: the real one if we have it, else its last one held
+// (a restart is a press, so that's never guessed)
+static SimInput RemoteFor(NetSession *ns, uint32_t t) {
+    if (t < ns->remoteUpTo) return ns->remote[t & RING_MASK];
+    SimInput guess = {0};
+    if (ns->remoteUpTo > 0) guess = ns->remote[(ns->remoteUpTo - 1) & RING_MASK];
+    guess.restart = false;
+    ns->remote[t & RING_MASK] = guess;
+    return guess;
+}
+
+// one tick, first time or again: snapshot before it, the checkpoint hash, then step
+static void RunTick(NetSession *ns, uint32_t t) {
+    GameState *s = ns->s;
+    // a save that can't grow leaves a stale snapshot, which shows up as a desync
+    SnapshotSave(&ns->snap[t & SNAP_MASK], s);
+    if (t % NET_HASH_EVERY == 0) {
+        ns->tickHash[t & RING_MASK] = SimHash(s);
+        ns->hashAt[t & RING_MASK] = t;
+    }
+
+    SimInput in[SIM_MAX_PLAYERS];
+    in[ns->self] = ns->local[t & RING_MASK];
+    in[1 - ns->self] = RemoteFor(ns, t);
+    SimStep(s, in, ns->step);
+    if (s->events & SIM_EVENT_GAME_OVER) {
+        ns->overTick = t;
+        ns->overScore = s->score;
+        ns->overTime = s->timeSinceStart;
+    }
+}
+
+// back to the snapshot before rollbackFrom and forward again to where we were. effects
+// the re-run emits are dropped, they already played (or never will, close enough). a
+// game over or new high score isn't: the re-run may be the first time it happens. the
+// telemetry log gets a rewind mark and the re-run ticks again, the reader drops what
+// they replace
+static void Rollback(NetSession *ns) {
+    if (ns->rollbackFrom >= ns->tick) { ns->rollbackFrom = NO_TICK; return; }
+    PROF_BEGIN(PROF_ROLLBACK);
+    uint32_t from = ns->rollbackFrom;
+    uint32_t n = ns->tick - from;
+    uint32_t fxCount = ns->s->fxCount;
+
+    SnapshotRestore(&ns->snap[from & SNAP_MASK], ns->s);
+    // a step logs under the tick it steps to
+    if (ns->s->telemetry) TelemetryRewind(ns->s->telemetry, ns->s->tick + 1, (int)n);
+    if (ns->overTick != NO_TICK && ns->overTick >= from) ns->overTick = NO_TICK;
+    for (uint32_t t = from; t < ns->tick; ++t) {
+        RunTick(ns, t);
+        ns->events |= ns->s->events & (SIM_EVENT_GAME_OVER | SIM_EVENT_NEW_HIGH);
+    }
+    ns->s->fxCount = fxCount;
+
+    ns->rollbacks++;
+    ns->resimTicks += n;
+    if (n > ns->maxRollback) ns->maxRollback = n;
+    ns->rollbackFrom = NO_TICK;
+    PROF_END(PROF_ROLLBACK);
+}
+
+// newest checkpoint with every input before it confirmed, and the peer's against it
+static void CheckHashes(NetSession *ns) {
+    uint32_t upTo = ns->remoteUpTo < ns->tick ? ns->remoteUpTo : ns->tick;
+    uint32_t c = upTo - upTo % NET_HASH_EVERY;
+    if (ns->hashAt[c & RING_MASK] == c && (ns->hashTick == NO_TICK || c > ns->hashTick)) ns->hashTick = c;
+
+    uint32_t p = ns->peerHashTick;
+    if (p == NO_TICK || ns->hashTick == NO_TICK || p > ns->hashTick) return;
+    if (ns->hashAt[p & RING_MASK] == p) {
+        ns->hashChecks++;
+        if (ns->tickHash[p & RING_MASK] != ns->peerHash) ns->desyncs++;
+    }
+    ns->peerHashTick = NO_TICK;      // checked, or too old to check
+}
+
+static void Receive(NetSession *ns) {
+    NetLink *l = ns->link;
+    unsigned char buf[NET_PACKET_MAX];
+    for (;;) {
+        ssize_t got = recv(l->fd, buf, sizeof(buf), 0);
+        if (got < 0) break;           // EAGAIN: nothing left (or an error, same thing here)
+        if (got < NET_PACKET_HEAD || memcmp(buf, "NTNP", 4) != 0 ||
+            GetLE(buf + 4, 8) != ns->s->seed || buf[12] != 1 - ns->self) { l->bad++; continue; }
+
+        uint32_t first = (uint32_t)GetLE(buf + 13, 4);
+        int count = buf[17];
+        if (count > NET_SEND_MAX || got < NET_PACKET_HEAD + count * 9) { l->bad++; continue; }
+        uint32_t ack = (uint32_t)GetLE(buf + 18, 4);
+        uint32_t hashTick = (uint32_t)GetLE(buf + 22, 4);
+        uint64_t hash = GetLE(buf + 26, 8);
+        l->received++;
+
+        SimInput in[NET_SEND_MAX];
+        for (int i = 0; i < count; ++i) {
+            const unsigned char *p = buf + NET_PACKET_HEAD + i * 9;
+            uint32_t bx = (uint32_t)GetLE(p, 4), by = (uint32_t)GetLE(p + 4, 4);
+            memcpy(&in[i].aim.x, &bx, sizeof(bx));
+            memcpy(&in[i].aim.y, &by, sizeof(by));
+            in[i].fire = (p[8] & 1) != 0;
+            in[i].restart = (p[8] & 2) != 0;
+        }
+        NetReceiveInputs(ns, first, count, in);
+        if (ack > ns->peerAck) ns->peerAck = ack;
+        if (hashTick != NO_TICK && (ns->peerHashSeen == NO_TICK || hashTick > ns->peerHashSeen)) {
+            ns->peerHashSeen = hashTick;
+            ns->peerHashTick = hashTick;
+            ns->peerHash = hash;
+        }
+    }
+}
+
+// everything the peer hasn't acked yet, the ack for theirs and our newest final hash
+static void Send(NetSession *ns) {
+    unsigned char buf[NET_PACKET_MAX];
+    uint32_t first = ns->peerAck;
+    int count = (int)(ns->localUpTo - first);
+    if (count > NET_SEND_MAX) count = NET_SEND_MAX;
+
+    memcpy(buf, "NTNP", 4);
+    PutLE(buf + 4, ns->s->seed, 8);
+    buf[12] = (unsigned char)ns->self;
+    PutLE(buf + 13, first, 4);
+    buf[17] = (unsigned char)count;
+    PutLE(buf + 18, ns->remoteUpTo, 4);
+    PutLE(buf + 22, ns->hashTick, 4);
+    PutLE(buf + 26, ns->hashTick != NO_TICK ? ns->tickHash[ns->hashTick & RING_MASK] : 0, 8);
+    for (int i = 0; i < count; ++i) {
+        const SimInput *in = &ns->local[(first + (uint32_t)i) & RING_MASK];
+        unsigned char *p = buf + NET_PACKET_HEAD + i * 9;
+        uint32_t bx, by;
+        memcpy(&bx, &in->aim.x, sizeof(bx));
+        memcpy(&by, &in->aim.y, sizeof(by));
+        PutLE(p, bx, 4);
+        PutLE(p + 4, by, 4);
+        p[8] = (unsigned char)((in->fire ? 1 : 0) | (in->restart ? 2 : 0));
+    }
+    LinkSend(ns->link, buf, NET_PACKET_HEAD + count * 9);
+}
+
+int NetAdvance(NetSession *ns, const SimInput *local, float frameTime) {
+    ns->events = 0;
+    ns->overFinal = false;
+    if (ns->link) {
+        LinkFlush(ns->link);
+        Receive(ns);
+    }
+    if (!ns->heard) {                 // nobody there yet: keep knocking, don't start the clock
+        Send(ns);
+        return 0;
+    }
+
+    Rollback(ns);
+
+    if (frameTime > SIM_MAX_FRAME) frameTime = SIM_MAX_FRAME;
+    ns->acc += frameTime;
+    if (ns->acc > SIM_MAX_FRAME) ns->acc = SIM_MAX_FRAME;   // stalled a while: don't sprint after
+
+    bool restart = local->restart || ns->restartPending;
+    int ticks = 0;
+    while (ns->acc >= ns->step && ns->tick < ns->maxTick) {
+        if (ns->tick >= ns->remoteUpTo + NET_WINDOW) {
+            ns->stalls++;
+            break;
+        }
+        // what we press now lands `delay` ticks out
+        SimInput mine = *local;
+        mine.restart = restart;
+        restart = false;
+        ns->local[ns->localUpTo & RING_MASK] = mine;
+        ns->localUpTo++;
+
+        if (ns->tick >= ns->remoteUpTo) ns->predictedTicks++;
+        RunTick(ns, ns->tick);
+        ns->tick++;
+        ns->events |= ns->s->events;
+        ns->acc -= ns->step;
+        ticks++;
+    }
+    ns->restartPending = restart;
+
+    // past the last confirmed input nothing can roll it back any more
+    if (ns->overTick != NO_TICK && NetSettled(ns, ns->overTick + 1)) {
+        ns->overFinal = true;
+        ns->overTick = NO_TICK;
+    }
+    CheckHashes(ns);
+    if (ns->link) Send(ns);
+    return ticks;
+}
@@ -0,0 +1,123 @@
+// NULL TERMINATOR — co-op over loopback UDP, with rollback
+// Two instances, one gunner each (SimSetPlayers(s, 2)), talking UDP on 127.0.0.1. Both
+// run the whole sim; only inputs go over the wire.
+//
+// Input delay + rollback:
+//   - our input sampled now is for tick + delay, so usually the peer has it before it
+//     gets there
+//   - a peer input that hasn't arrived yet is predicted (its last known one, held)
+//   - when the real one turns up for a tick that already ran on a different guess, the
+//     state goes back to the snapshot from before that tick and every tick since is
+//     simulated again with what we know now
+// Events from a tick that ran on a guess may not survive the rollback, so a game over
+// only counts (leaderboard) once every input up to it is confirmed: overFinal.
+// A snapshot (src/snapshot.c) is taken before every tick and kept for NET_WINDOW ticks,
+// as far back as a rollback can go.
+// The sim never gets more than NET_WINDOW ticks past the last confirmed peer input; it
+// stalls there until the peer catches up.
+//
+// Every packet resends all of our inputs the peer hasn't acked, so a lost packet only
+// costs a later rollback. Every NET_HASH_EVERY ticks each side hashes the state once
+// both inputs for it are final and sends it along; a mismatch is counted as a desync.
+//
+// packet, little-endian:
+//   "NTNP"  u64 seed  u8 player (sender's)  u32 firstTick  u8 count
+//   u32 ack (peer inputs we have, ticks < ack)  u32 hashTick  u64 hash (hashTick = UINT32_MAX none)
+//   count x { f32 aim.x  f32 aim.y  u8 flags (1 fire, 2 restart) }
+
+#ifndef NT_NET_H
+#define NT_NET_H
+
+#include "sim.h"
+#include "snapshot.h"
+#include "rng.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define NET_WINDOW      32       // most ticks we run ahead of the peer's confirmed input, power of two
+#define NET_RING        128      // inputs kept, power of two, > 2 * (NET_WINDOW + NET_MAX_DELAY)
+#define NET_MAX_DELAY   16
+#define NET_HASH_EVERY  16
+#define NET_SEND_MAX    (2 * (NET_WINDOW + NET_MAX_DELAY))   // inputs per packet, covers everything unacked
+#define NET_PACKET_HEAD 34
+#define NET_PACKET_MAX  (NET_PACKET_HEAD + NET_SEND_MAX * 9)
+#define NET_OUTBOX      256      // packets held back by simulated lag
+
+// UDP on loopback, plus optional made-up lag / jitter / loss on what we send, so the
+// rollback path gets exercised on one box
+typedef struct {
+    int fd;
+    uint16_t peerPort;
+    int lagMs, jitterMs, lossPct;
+    Rng rng;
+
+    struct { uint64_t due; int len; unsigned char data[NET_PACKET_MAX]; } outbox[NET_OUTBOX];
+    int outCount;
+    uint32_t sent, received, lost, bad;    // lost = dropped on purpose, bad = not ours / garbled
+} NetLink;
+
+// bind 127.0.0.1:port, send to 127.0.0.1:peerPort. false if the socket couldn't be set up
+bool NetLinkOpen(NetLink *l, uint16_t port, uint16_t peerPort);
+void NetLinkClose(NetLink *l);
+
+typedef struct {
+    GameState *s;
+    NetLink *link;               // NULL: no network, inputs only come in by NetReceiveInputs
+    int self;                    // our player index, the peer is 1 - self
+    int delay;                   // input delay, ticks
+    float step, acc;
+    bool restartPending;         // R on a frame too short for a tick
+
+    uint32_t tick;               // next tick to simulate (ticks since the session started)
+    uint32_t maxTick;            // don't simulate past this (UINT32_MAX = no limit)
+    SimInput local[NET_RING];    // by tick
+    SimInput remote[NET_RING];   // by tick: confirmed below remoteUpTo, guesses above
+    uint32_t localUpTo;          // our inputs known for ticks < localUpTo
+    uint32_t remoteUpTo;         // peer inputs confirmed for ticks < remoteUpTo
+    uint32_t peerAck;            // peer has our inputs for ticks < peerAck
+    uint32_t rollbackFrom;       // earliest tick that ran on a wrong guess, UINT32_MAX if none
+    bool heard;                  // got anything from the peer yet
+
+    Snapshot snap[NET_WINDOW];   // state before each of the last NET_WINDOW ticks
+
+    // SimHash before every NET_HASH_EVERY'th tick, tagged with the tick (a rollback
+    // through it rewrites it). final once every input before it is confirmed
+    uint64_t tickHash[NET_RING];
+    uint32_t hashAt[NET_RING];
+    uint32_t hashTick;           // newest final hashed tick, sent to the peer (UINT32_MAX none)
+    uint32_t peerHashTick;       // the peer's newest, waiting for ours to catch up (UINT32_MAX none)
+    uint64_t peerHash;
+    uint32_t peerHashSeen;       // newest the peer sent, so a late duplicate isn't checked twice
+
+    unsigned events;             // SIM_EVENT_* from ticks simulated last advance (re-runs: GAME_OVER, NEW_HIGH only)
+
+    // the run that ended most recently: the tick whose step raised SIM_EVENT_GAME_OVER
+    // and what it ended on. a rollback through that tick forgets it until the re-run
+    // gets there again. overFinal is set for the one advance that confirms it (every
+    // input up to it final), that's the one to put on the leaderboard
+    uint32_t overTick;           // UINT32_MAX none
+    int overScore;
+    float overTime;
+    bool overFinal;
+
+    // counters
+    uint32_t rollbacks, resimTicks, maxRollback, stalls, desyncs, hashChecks;
+    uint32_t predictedTicks;     // ticks first simulated on a guess
+} NetSession;
+
+// s must be freshly SimInit'd with the same seed on both sides and set to two players.
+// link may be NULL (tests/bench). false if snapshots couldn't be allocated
+bool NetSessionInit(NetSession *ns, GameState *s, NetLink *link, int self, int delay, int hz);
+void NetSessionFree(NetSession *ns);
+
+// one frame: read packets, roll back if a guess was wrong, run the ticks frameTime
+// covers with `local` as our input, send. returns ticks simulated for the first time
+int NetAdvance(NetSession *ns, const SimInput *local, float frameTime);
+
+// peer inputs for ticks [first, first + count), same as a packet carrying them
+void NetReceiveInputs(NetSession *ns, uint32_t first, int count, const SimInput *in);
+
+// every tick below `tick` has both inputs confirmed and has been simulated with them
+bool NetSettled(const NetSession *ns, uint32_t tick);
+
+#endif
@@ -0,0 +1,89 @@
+// NULL TERMINATOR — particles
+
+#include "particles.h"
+#include "kernels.h"
+#include "mem.h"
+#include <math.h>
+#include <string.h>
+
+#define MASK (PARTICLE_CAP - 1)
+#define DRAG 3.0f                    // velocity falls off by e every 1/DRAG seconds
+
+bool ParticlesInit(ParticleSystem *ps, uint64_t seed) {
+    memset(ps, 0, sizeof(*ps));
+    float *block = MemAlloc(MEM_PARTICLES, sizeof(float) * PARTICLE_CAP * 6);
+    if (!block) return false;
+    ps->x = block;                    ps->y = block + PARTICLE_CAP;
+    ps->vx = block + 2 * PARTICLE_CAP; ps->vy = block + 3 * PARTICLE_CAP;
+    ps->life = block + 4 * PARTICLE_CAP; ps->shrink = block + 5 * PARTICLE_CAP;
+    RngSeed(&ps->rng, seed);
+    return true;
+}
+
+void ParticlesFree(ParticleSystem *ps) {
+    MemFree(ps->x);
+    memset(ps, 0, sizeof(*ps));
+}
+
+void ParticlesClear(ParticleSystem *ps) {
+    ps->tail = ps->head;
+}
+
+void ParticlesBurst(ParticleSystem *ps, Vec2 pos, Vec2 dir, float spread, int count,
+                    float speedMin, float speedMax, float lifeMin, float lifeMax, float r) {
+    bool aimed = dir.x != 0.0f || dir.y != 0.0f;
+    float base = aimed ? atan2f(dir.y, dir.x) : 0.0f;
+    if (!aimed) spread = SIM_PI;
+    for (int k = 0; k < count; ++k) {
+        if (ps->head - ps->tail == PARTICLE_CAP) {
+            ps->tail++;
+            ps->overwritten++;
+        }
+        uint32_t i = ps->head++ & MASK;
+        float ang = base + (RngFloat(&ps->rng) * 2.0f - 1.0f) * spread;
+        float speed = speedMin + (speedMax - speedMin) * RngFloat(&ps->rng);
+        float life = lifeMin + (lifeMax - lifeMin) * RngFloat(&ps->rng);
+        ps->x[i] = pos.x;
+        ps->y[i] = pos.y;
+        ps->vx[i] = cosf(ang) * speed;
+        ps->vy[i] = sinf(ang) * speed;
+        ps->life[i] = life;
+        ps->shrink[i] = r / life;
+    }
+}
+
+void ParticlesEmitFx(ParticleSystem *ps, const GameState *s) {
+    // fell behind by more than the ring holds: skip to what's still there
+    if (s->fxCount - ps->fxSeen > SIM_FX_RING) ps->fxSeen = s->fxCount - SIM_FX_RING;
+    for (; ps->fxSeen != s->fxCount; ps->fxSeen++) {
+        const SimFx *fx = &s->fx[ps->fxSeen & (SIM_FX_RING - 1)];
+        switch (fx->kind) {
+            case SIM_FX_KILL:       ParticlesBurst(ps, fx->pos, fx->dir, 1.2f, 24, 40.0f, 260.0f, 0.25f, 0.55f, 3.0f); break;
+            case SIM_FX_PLAYER_HIT: ParticlesBurst(ps, fx->pos, (Vec2){ 0 }, 0.0f, 40, 60.0f, 320.0f, 0.4f, 0.8f, 2.5f); break;
+            case SIM_FX_SHOTGUN:    ParticlesBurst(ps, fx->pos, fx->dir, 0.35f, 14, 250.0f, 600.0f, 0.08f, 0.18f, 1.5f); break;
+        }
+    }
+}
+
+// one contiguous run of ring slots
+static void StepRange(ParticleSystem *ps, uint32_t from, int n, float dt, float damp) {
+    KernelIntegrate(ps->x + from, ps->y + from, ps->vx + from, ps->vy + from, n, dt);
+    KernelScale2(ps->vx + from, ps->vy + from, n, damp);
+    KernelAge(ps->life + from, n, dt);
+}
+
+void ParticlesUpdate(ParticleSystem *ps, float dt) {
+    uint32_t n = ps->head - ps->tail;
+    if (n == 0) return;
+    float damp = expf(-DRAG * dt);
+    uint32_t from = ps->tail & MASK;
+    uint32_t first = n < PARTICLE_CAP - from ? n : PARTICLE_CAP - from;    // up to the end of the ring
+    StepRange(ps, from, (int)first, dt, damp);
+    if (first < n) StepRange(ps, 0, (int)(n - first), dt, damp);
+
+    while (ps->tail != ps->head && ps->life[ps->tail & MASK] <= 0.0f) ps->tail++;
+}
+
+int ParticlesLive(const ParticleSystem *ps) {
+    return (int)(ps->head - ps->tail);
+}
@@ -0,0 +1,49 @@
+// NULL TERMINATOR — particles
+// Death bursts, shotgun sparks and hit debris. Purely cosmetic: stepped with the
+// frame time, own rng, never read by the sim.
+//
+// A fixed ring of PARTICLE_CAP particles, allocated once. New particles go in at the
+// head, and since they all live about as long, they die roughly in the order they
+// were born: the live ones are the window [tail, head) and the tail just walks past
+// the dead. A full ring overwrites its oldest particles instead of growing.
+// Storage is structure-of-arrays, so the update is the same SIMD kernels the pools use.
+
+#ifndef NT_PARTICLES_H
+#define NT_PARTICLES_H
+
+#include "sim.h"
+#include "rng.h"
+
+// the window spans the longest lifetime while the average one sets how many are
+// actually alive, so this is ~2.5x the 100k we want to hold
+#define PARTICLE_CAP (1 << 18)       // 262144, power of two
+
+typedef struct {
+    float *x, *y, *vx, *vy;
+    float *life;             // seconds left
+    float *shrink;           // radius = life * shrink, so they shrink to nothing as they die
+    uint32_t head, tail;     // live window, ring index = n & (PARTICLE_CAP - 1)
+    uint32_t fxSeen;         // GameState.fx records already turned into particles
+    Rng rng;
+    int overwritten;         // particles dropped early because the ring was full
+} ParticleSystem;
+
+// false if the arrays couldn't be allocated
+bool ParticlesInit(ParticleSystem *ps, uint64_t seed);
+void ParticlesFree(ParticleSystem *ps);
+void ParticlesClear(ParticleSystem *ps);
+
+// count particles from pos, headings within +-spread (radians) of dir (a zero dir
+// means all around), random speed and life in the given ranges, starting radius r
+void ParticlesBurst(ParticleSystem *ps, Vec2 pos, Vec2 dir, float spread, int count,
+                    float speedMin, float speedMax, float lifeMin, float lifeMax, float r);
+
+// bursts for every effect record the sim wrote since the last call
+void ParticlesEmitFx(ParticleSystem *ps, const GameState *s);
+
+// move, slow down, age, then drop dead ones off the tail
+void ParticlesUpdate(ParticleSystem *ps, float dt);
+
+int ParticlesLive(const ParticleSystem *ps);    // the window, may include a few dead ones
+
+#endif
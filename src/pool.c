@@ -0,0 +1,348 @@
+// NULL TERMINATOR — entity pools
+
+#include "pool.h"
+#include "kernels.h"
+#include "mem.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// MemAlloc with the raw pointer stashed right before the aligned block
+static void *AlignedAlloc(size_t bytes) {
+    void *raw = MemAlloc(MEM_POOLS, bytes + KERNEL_ALIGN + sizeof(void *));
+    if (!raw) return NULL;
+    uintptr_t base = ((uintptr_t)raw + sizeof(void *) + KERNEL_ALIGN - 1) & ~(uintptr_t)(KERNEL_ALIGN - 1);
+    ((void **)base)[-1] = raw;
+    return (void *)base;
+}
+
+static void AlignedFree(void *p) {
+    if (p) MemFree(((void **)p)[-1]);
+}
+
+// one more chunk plus the handle slots that come with it
+static bool Grow(EntityPool *p) {
+    int newCap = p->capacity + POOL_CHUNK_SIZE;
+    if (newCap > POOL_MAX_ENTITIES) return false;
+
+    PoolChunk **chunks = MemRealloc(MEM_POOLS, p->chunks, sizeof(*chunks) * (size_t)(p->chunkCount + 1));
+    if (!chunks) return false;
+    p->chunks = chunks;
+
+    // handle bookkeeping can move (handles are slot numbers, not pointers)
+    uint32_t *gen = MemRealloc(MEM_POOLS, p->gen, sizeof(*gen) * (size_t)newCap);
+    if (gen) p->gen = gen;
+    int32_t *denseOf = MemRealloc(MEM_POOLS, p->denseOf, sizeof(*denseOf) * (size_t)newCap);
+    if (denseOf) p->denseOf = denseOf;
+    int32_t *freeSlots = MemRealloc(MEM_POOLS, p->freeSlots, sizeof(*freeSlots) * (size_t)newCap);
+    if (freeSlots) p->freeSlots = freeSlots;
+    PoolChunk *chunk = AlignedAlloc(sizeof(PoolChunk));
+    if (!gen || !denseOf || !freeSlots || !chunk) {
+        AlignedFree(chunk);
+        return false;
+    }
+
+    p->chunks[p->chunkCount++] = chunk;
+    // new slots go on the free stack so the lowest one is handed out first
+    for (int s = newCap - 1; s >= p->capacity; --s) {
+        p->gen[s] = 0;
+        p->denseOf[s] = -1;
+        p->freeSlots[p->freeCount++] = s;
+    }
+    p->capacity = newCap;
+    p->grows++;
+    return true;
+}
+
+bool PoolInit(EntityPool *p, int reserve) {
+    memset(p, 0, sizeof(*p));
+    return PoolReserve(p, reserve);
+}
+
+void PoolFree(EntityPool *p) {
+    for (int c = 0; c < p->chunkCount; ++c) AlignedFree(p->chunks[c]);
+    MemFree(p->chunks);
+    MemFree(p->gen);
+    MemFree(p->denseOf);
+    MemFree(p->freeSlots);
+    memset(p, 0, sizeof(*p));
+}
+
+bool PoolReserve(EntityPool *p, int n) {
+    while (p->capacity < n) {
+        if (!Grow(p)) return false;
+    }
+    return true;
+}
+
+void PoolClear(EntityPool *p) {
+    for (int i = p->count - 1; i >= 0; --i) {
+        int32_t s = POOL_GET(p, slot, i);
+        p->gen[s]++;
+        p->denseOf[s] = -1;
+        p->freeSlots[p->freeCount++] = s;
+    }
+    p->count = 0;
+}
+
+int PoolPush(EntityPool *p, float x, float y, float vx, float vy, float life) {
+    if (p->count >= p->capacity && !Grow(p)) {
+        p->dropped++;
+        return -1;
+    }
+    int i = p->count++;
+    PoolChunk *ch = POOL_CHUNK(p, i);
+    int l = POOL_LANE(i);
+    ch->x[l] = x;   ch->y[l] = y;
+    ch->px[l] = x;  ch->py[l] = y;     // nothing to blend from yet
+    ch->vx[l] = vx; ch->vy[l] = vy;
+    ch->life[l] = life;
+
+    int32_t s = p->freeSlots[--p->freeCount];
+    ch->slot[l] = s;
+    p->denseOf[s] = i;
+    if (p->count > p->highWater) p->highWater = p->count;
+    return i;
+}
+
+int PoolPushN(EntityPool *p, int n, int *pushed) {
+    int first = p->count;
+    while (p->capacity - p->count < n && Grow(p)) {}
+    int got = p->capacity - p->count < n ? p->capacity - p->count : n;
+    p->dropped += n - got;
+
+    for (int i = first; i < first + got; ++i) {
+        int32_t s = p->freeSlots[--p->freeCount];
+        POOL_GET(p, slot, i) = s;
+        p->denseOf[s] = i;
+    }
+    p->count += got;
+    if (p->count > p->highWater) p->highWater = p->count;
+    *pushed = got;
+    return first;
+}
+
+void PoolRemove(EntityPool *p, int i) {
+    int last = --p->count;
+    PoolChunk *dc = POOL_CHUNK(p, i), *sc = POOL_CHUNK(p, last);
+    int d = POOL_LANE(i), s = POOL_LANE(last);
+
+    int32_t dead = dc->slot[d];
+    p->gen[dead]++;
+    p->denseOf[dead] = -1;
+    p->freeSlots[p->freeCount++] = dead;
+
+    if (i != last) {
+        dc->x[d] = sc->x[s];   dc->y[d] = sc->y[s];
+        dc->px[d] = sc->px[s]; dc->py[d] = sc->py[s];
+        dc->vx[d] = sc->vx[s]; dc->vy[d] = sc->vy[s];
+        dc->life[d] = sc->life[s];
+        dc->slot[d] = sc->slot[s];
+        p->denseOf[dc->slot[d]] = i;
+    }
+}
+
+EntityHandle PoolHandleOf(const EntityPool *p, int i) {
+    int32_t s = POOL_GET(p, slot, i);
+    return (EntityHandle){ s, p->gen[s] };
+}
+
+int PoolResolve(const EntityPool *p, EntityHandle h) {
+    if (h.slot < 0 || h.slot >= p->capacity || p->gen[h.slot] != h.gen) return -1;
+    return p->denseOf[h.slot];
+}
+
+int PoolStepChunks(EntityPool *p, int c0, int c1, float dt, bool withLife,
+                   float minX, float minY, float maxX, float maxY) {
+    int dead = 0;
+    for (int c = c0; c < c1; ++c) {
+        PoolChunk *ch = p->chunks[c];
+        int n = POOL_CHUNK_COUNT(p, c);
+        memcpy(ch->px, ch->x, sizeof(float) * (size_t)n);
+        memcpy(ch->py, ch->y, sizeof(float) * (size_t)n);
+        KernelIntegrate(ch->x, ch->y, ch->vx, ch->vy, n, dt);
+        if (withLife) KernelAge(ch->life, n, dt);
+        dead += KernelCullMask(ch->x, ch->y, withLife ? ch->life : NULL, n, minX, minY, maxX, maxY, ch->mark);
+    }
+    return dead;
+}
+
+void PoolRemoveMarked(EntityPool *p) {
+    // whatever gets swapped in from the back was already checked (and is alive)
+    for (int i = p->count - 1; i >= 0; --i) {
+        if (POOL_GET(p, mark, i)) PoolRemove(p, i);
+    }
+}
+
+int PoolUpdate(EntityPool *p, float dt, bool withLife,
+               float minX, float minY, float maxX, float maxY) {
+    int dead = PoolStepChunks(p, 0, POOL_USED_CHUNKS(p), dt, withLife, minX, minY, maxX, maxY);
+    if (dead > 0) PoolRemoveMarked(p);
+    return dead;
+}
+
+// the fields a snapshot keeps, in file order (slot and mark are bookkeeping/scratch)
+static const size_t flatFields[POOL_FLAT_FIELDS] = {
+    offsetof(PoolChunk, x),  offsetof(PoolChunk, y),
+    offsetof(PoolChunk, px), offsetof(PoolChunk, py),
+    offsetof(PoolChunk, vx), offsetof(PoolChunk, vy),
+    offsetof(PoolChunk, life),
+};
+size_t PoolFlatSize(const EntityPool *p) {
+    return sizeof(float) * POOL_FLAT_FIELDS * (size_t)p->count;
+}
+
+unsigned char *PoolFlatSave(const EntityPool *p, unsigned char *dst) {
+    for (int f = 0; f < POOL_FLAT_FIELDS; ++f) {
+        for (int c = 0; c < POOL_USED_CHUNKS(p); ++c) {
+            size_t bytes = sizeof(float) * (size_t)POOL_CHUNK_COUNT(p, c);
+            memcpy(dst, (const unsigned char *)p->chunks[c] + flatFields[f], bytes);
+            dst += bytes;
+        }
+    }
+    return dst;
+}
+
+bool PoolFlatLoad(EntityPool *p, int count, const unsigned char *src) {
+    if (!PoolReserve(p, count)) {
+        PoolClear(p);
+        return false;
+    }
+    p->count = count;
+    for (int f = 0; f < POOL_FLAT_FIELDS; ++f) {
+        for (int c = 0; c < POOL_USED_CHUNKS(p); ++c) {
+            size_t bytes = sizeof(float) * (size_t)POOL_CHUNK_COUNT(p, c);
+            memcpy((unsigned char *)p->chunks[c] + flatFields[f], src, bytes);
+            src += bytes;
+        }
+    }
+
+    // rebuild the handle table in straight passes instead of freeing and re-taking
+    // slots one by one: entity i gets slot i, and every slot's generation moves on so
+    // all handles from before go stale
+    for (int s = 0; s < p->capacity; ++s) {
+        p->gen[s]++;
+        p->denseOf[s] = s < count ? s : -1;
+    }
+    p->freeCount = 0;
+    for (int s = p->capacity - 1; s >= count; --s) p->freeSlots[p->freeCount++] = s;
+    for (int c = 0; c < POOL_USED_CHUNKS(p); ++c) {
+        int32_t *slot = p->chunks[c]->slot, base = c << POOL_CHUNK_SHIFT;
+        for (int l = 0; l < POOL_CHUNK_COUNT(p, c); ++l) slot[l] = base + l;
+    }
+    if (count > p->highWater) p->highWater = count;
+    return true;
+}
+
+int PoolWithin(EntityPool *p, float px, float py, float r2) {
+    int hits = 0;
+    for (int c = 0; c < POOL_USED_CHUNKS(p); ++c) {
+        PoolChunk *ch = p->chunks[c];
+        hits += KernelWithin(ch->x, ch->y, POOL_CHUNK_COUNT(p, c), px, py, r2, ch->mark);
+    }
+    return hits;
+}
+
+int PoolSwept(EntityPool *p, float px, float py, float pvx, float pvy, float dt, float r2) {
+    int hits = 0;
+    for (int c = 0; c < POOL_USED_CHUNKS(p); ++c) {
+        PoolChunk *ch = p->chunks[c];
+        hits += KernelSwept(ch->x, ch->y, ch->vx, ch->vy, ch->life, POOL_CHUNK_COUNT(p, c),
+                            px, py, pvx, pvy, dt, r2, ch->mark);
+    }
+    return hits;
+}
+
+void PoolClearMarks(EntityPool *p) {
+    for (int c = 0; c < POOL_USED_CHUNKS(p); ++c) memset(p->chunks[c]->mark, 0, (size_t)POOL_CHUNK_COUNT(p, c));
+}
+
+float PoolMaxSpeed(const EntityPool *p) {
+    float best = 0.0f;
+    for (int c = 0; c < POOL_USED_CHUNKS(p); ++c) {
+        float l2 = KernelMaxLen2(p->chunks[c]->vx, p->chunks[c]->vy, POOL_CHUNK_COUNT(p, c));
+        if (l2 > best) best = l2;
+    }
+    return sqrtf(best);
+}
+
+
+static bool ListGrow(ChunkList *l) {
+    if (l->capacity + LIST_CHUNK_SIZE > POOL_MAX_ENTITIES) return false;
+    unsigned char **chunks = MemRealloc(l->tag, l->chunks, sizeof(*chunks) * (size_t)(l->chunkCount + 1));
+    if (!chunks) return false;
+    l->chunks = chunks;
+    unsigned char *chunk = MemAlloc(l->tag, (size_t)l->elemSize * LIST_CHUNK_SIZE);
+    if (!chunk) return false;
+    l->chunks[l->chunkCount++] = chunk;
+    l->capacity += LIST_CHUNK_SIZE;
+    l->grows++;
+    return true;
+}
+
+bool ChunkListInit(ChunkList *l, int elemSize, int reserve, MemTag tag) {
+    memset(l, 0, sizeof(*l));
+    l->elemSize = elemSize;
+    l->tag = tag;
+    while (l->capacity < reserve) {
+        if (!ListGrow(l)) return false;
+    }
+    return true;
+}
+
+void ChunkListFree(ChunkList *l) {
+    for (int c = 0; c < l->chunkCount; ++c) MemFree(l->chunks[c]);
+    MemFree(l->chunks);
+    int elemSize = l->elemSize;
+    MemTag tag = l->tag;
+    memset(l, 0, sizeof(*l));
+    l->elemSize = elemSize;
+    l->tag = tag;
+}
+
+void ChunkListClear(ChunkList *l) {
+    l->count = 0;
+}
+
+void *ChunkListAt(const ChunkList *l, int i) {
+    return l->chunks[i / LIST_CHUNK_SIZE] + (size_t)(i % LIST_CHUNK_SIZE) * (size_t)l->elemSize;
+}
+
+void *ChunkListPush(ChunkList *l) {
+    if (l->count >= l->capacity && !ListGrow(l)) {
+        l->dropped++;
+        return NULL;
+    }
+    void *e = ChunkListAt(l, l->count++);
+    if (l->count > l->highWater) l->highWater = l->count;
+    return e;
+}
+
+unsigned char *ChunkListFlatSave(const ChunkList *l, unsigned char *dst) {
+    for (int done = 0; done < l->count; done += LIST_CHUNK_SIZE) {
+        int n = l->count - done < LIST_CHUNK_SIZE ? l->count - done : LIST_CHUNK_SIZE;
+        memcpy(dst, l->chunks[done / LIST_CHUNK_SIZE], (size_t)n * (size_t)l->elemSize);
+        dst += (size_t)n * (size_t)l->elemSize;
+    }
+    return dst;
+}
+
+bool ChunkListFlatLoad(ChunkList *l, int count, const unsigned char *src) {
+    while (l->capacity < count) {
+        if (!ListGrow(l)) return false;
+    }
+    l->count = count;
+    for (int done = 0; done < count; done += LIST_CHUNK_SIZE) {
+        int n = count - done < LIST_CHUNK_SIZE ? count - done : LIST_CHUNK_SIZE;
+        memcpy(l->chunks[done / LIST_CHUNK_SIZE], src, (size_t)n * (size_t)l->elemSize);
+        src += (size_t)n * (size_t)l->elemSize;
+    }
+    if (count > l->highWater) l->highWater = count;
+    return true;
+}
+
+void ChunkListRemove(ChunkList *l, int i) {
+    int last = --l->count;
+    if (i != last) memcpy(ChunkListAt(l, i), ChunkListAt(l, last), (size_t)l->elemSize);
+}
@@ -0,0 +1,156 @@
+// NULL TERMINATOR — entity pools
+// Structure-of-arrays storage for bullets and enemies: one aligned float array per
+// field so the update and distance kernels stream straight through memory.
+//
+// Storage comes in fixed chunks of POOL_CHUNK_SIZE entities. Running out of room adds
+// a chunk, it never reallocates, so live entities don't move and nothing gets dropped
+// at a cap. Chunks are kept after a reset, so once a pool has seen its high-water
+// mark, steady-state play never allocates.
+//
+// Removal is swap-with-last like the old arrays, so dense indices shift around.
+// Anything that needs to refer to an entity across ticks holds an EntityHandle
+// (slot + generation) instead and resolves it with PoolResolve.
+
+#ifndef NT_POOL_H
+#define NT_POOL_H
+
+#include "mem.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define POOL_CHUNK_SHIFT 10
+#define POOL_CHUNK_SIZE  (1 << POOL_CHUNK_SHIFT)   // entities per chunk
+#define POOL_MAX_ENTITIES (1 << 22)                // sanity limit, ~4M per pool
+
+typedef struct {
+    float x[POOL_CHUNK_SIZE], y[POOL_CHUNK_SIZE];     // position
+    float px[POOL_CHUNK_SIZE], py[POOL_CHUNK_SIZE];   // position before the last update (render interpolates)
+    float vx[POOL_CHUNK_SIZE], vy[POOL_CHUNK_SIZE];   // velocity
+    float life[POOL_CHUNK_SIZE];                      // seconds left (bullets), unused by enemies
+    int32_t slot[POOL_CHUNK_SIZE];                    // handle slot of the entity at each index
+    unsigned char mark[POOL_CHUNK_SIZE];              // scratch for the cull/hit kernels
+} PoolChunk;
+
+typedef struct {
+    int32_t slot;
+    uint32_t gen;
+} EntityHandle;
+
+typedef struct {
+    PoolChunk **chunks;
+    int chunkCount;
+    int count;
+    int capacity;         // chunkCount * POOL_CHUNK_SIZE
+
+    // handle table, one entry per capacity slot
+    uint32_t *gen;        // bumped every time the slot's entity dies
+    int32_t *denseOf;     // slot -> current index (-1 when free)
+    int32_t *freeSlots;   // stack of unused slots
+    int freeCount;
+
+    // counters
+    int highWater;        // most entities alive at once
+    int grows;            // chunk allocations so far
+    int dropped;          // pushes refused (allocation failed or POOL_MAX_ENTITIES)
+} EntityPool;
+
+// chunk / lane of dense index i, and field access by index
+#define POOL_CHUNK(p, i)        ((p)->chunks[(i) >> POOL_CHUNK_SHIFT])
+#define POOL_LANE(i)            ((i) & (POOL_CHUNK_SIZE - 1))
+#define POOL_GET(p, field, i)   (POOL_CHUNK(p, i)->field[POOL_LANE(i)])
+
+// entities in chunk c (only the last chunk is partly used)
+#define POOL_CHUNK_COUNT(p, c)  ((p)->count - ((c) << POOL_CHUNK_SHIFT) < POOL_CHUNK_SIZE ? \
+                                 (p)->count - ((c) << POOL_CHUNK_SHIFT) : POOL_CHUNK_SIZE)
+#define POOL_USED_CHUNKS(p)     (((p)->count + POOL_CHUNK_SIZE - 1) >> POOL_CHUNK_SHIFT)
+
+// reserve room for `reserve` entities up front, false if that allocation failed
+bool PoolInit(EntityPool *p, int reserve);
+void PoolFree(EntityPool *p);
+
+// make sure n entities fit without allocating later
+bool PoolReserve(EntityPool *p, int n);
+
+// drop everything (handles to old entities go stale), keep the memory
+void PoolClear(EntityPool *p);
+
+// append, returns the new index or -1 if the pool couldn't grow
+int PoolPush(EntityPool *p, float x, float y, float vx, float vy, float life);
+
+// append n at once (fewer if the pool can't grow that far, *pushed says how many).
+// returns the index of the first; only their handles are set up, the caller fills
+// x/y/px/py/vx/vy/life for [first, first + *pushed) before anything else looks at them
+int PoolPushN(EntityPool *p, int n, int *pushed);
+
+// swap-remove: last entity moves into i
+void PoolRemove(EntityPool *p, int i);
+
+EntityHandle PoolHandleOf(const EntityPool *p, int i);
+
+// current index of a handle's entity, or -1 if it has died since
+int PoolResolve(const EntityPool *p, EntityHandle h);
+
+// remember positions as prev, integrate (and age if withLife), then drop everything outside the box
+// (or out of life). removal walks from the back, same order as the old scalar loops.
+// returns how many were removed
+int PoolUpdate(EntityPool *p, float dt, bool withLife,
+               float minX, float minY, float maxX, float maxY);
+
+// PoolUpdate in two halves so the first can be split across threads:
+// step chunks [c0, c1) and mark the dead (returns how many), then remove every marked
+// entity once all chunks are done
+int PoolStepChunks(EntityPool *p, int c0, int c1, float dt, bool withLife,
+                   float minX, float minY, float maxX, float maxY);
+void PoolRemoveMarked(EntityPool *p);
+
+// flat copy of the live entities for snapshots: each field as one array over all of
+// them (x[0..count), y[0..count), ...), no handle slots. PoolFlatSize bytes
+#define POOL_FLAT_FIELDS 7        // x y px py vx vy life
+size_t PoolFlatSize(const EntityPool *p);
+unsigned char *PoolFlatSave(const EntityPool *p, unsigned char *dst);     // returns dst + size
+
+// replace the whole pool with count entities saved by PoolFlatSave. they get fresh
+// handles (old ones go stale). false if the pool couldn't grow that far
+bool PoolFlatLoad(EntityPool *p, int count, const unsigned char *src);
+
+// mark[i] = 1 for every entity within sqrt(r2) of (px, py), returns how many
+int PoolWithin(EntityPool *p, float px, float py, float r2);
+
+// mark[i] = 1 for every entity that passes within sqrt(r2) of a circle at (px, py) moving
+// at (pvx, pvy) over the next dt (or what's left of its life), returns how many (KernelSwept)
+int PoolSwept(EntityPool *p, float px, float py, float pvx, float pvy, float dt, float r2);
+
+// mark[i] = 0 for every entity
+void PoolClearMarks(EntityPool *p);
+
+// fastest entity's speed, 0 when empty
+float PoolMaxSpeed(const EntityPool *p);
+
+
+// same chunk rules for small plain structs (shot traces): array-of-structs, swap-remove,
+// grows a chunk at a time, never moves what's already there. no handles
+#define LIST_CHUNK_SIZE 128
+
+typedef struct {
+    unsigned char **chunks;
+    int chunkCount;
+    int count;
+    int capacity;
+    int elemSize;
+    MemTag tag;              // what its memory is counted as
+    int highWater, grows, dropped;
+} ChunkList;
+
+bool  ChunkListInit(ChunkList *l, int elemSize, int reserve, MemTag tag);
+void  ChunkListFree(ChunkList *l);
+void  ChunkListClear(ChunkList *l);
+void *ChunkListPush(ChunkList *l);             // room for one more, NULL if it couldn't grow
+void *ChunkListAt(const ChunkList *l, int i);
+void  ChunkListRemove(ChunkList *l, int i);    // swap-remove
+
+// same flat copy for lists: count elements back to back
+unsigned char *ChunkListFlatSave(const ChunkList *l, unsigned char *dst);
+bool ChunkListFlatLoad(ChunkList *l, int count, const unsigned char *src);
+
+#endif
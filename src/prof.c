@@ -0,0 +1,99 @@
+// NULL TERMINATOR — per-phase profiler
+
+#define _POSIX_C_SOURCE 199309L
+#include "prof.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static const char *phaseNames[PROF_PHASE_COUNT] = {
+    "frame", "input", "tick", "spawn", "rollback", "update_bullets", "update_enemies",
+    "collide_bullets", "collide_player", "render_build", "particles", "draw_traces", "draw_bullets",
+    "draw_enemies", "draw_particles", "draw_hud", "hud_redraw", "draw_banners",
+};
+
+static ProfSample ring[PROF_RING_SIZE];
+static uint64_t ringHead;                 // total samples ever written (atomic)
+
+// per-phase scratch for ProfSummarize
+static uint32_t sortBuf[PROF_PHASE_COUNT][PROF_RING_SIZE];
+
+const char *ProfPhaseName(ProfPhase phase) {
+    return (phase >= 0 && phase < PROF_PHASE_COUNT) ? phaseNames[phase] : "?";
+}
+
+uint64_t ProfNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void ProfRecord(ProfPhase phase, uint64_t start, uint64_t end) {
+    uint64_t i = __atomic_fetch_add(&ringHead, 1, __ATOMIC_RELAXED);
+    uint64_t d = end - start;
+    ring[i & (PROF_RING_SIZE - 1)] = (ProfSample){ start, d > UINT32_MAX ? UINT32_MAX : (uint32_t)d, (uint32_t)phase };
+}
+
+void ProfClear(void) {
+    __atomic_store_n(&ringHead, 0, __ATOMIC_RELAXED);
+}
+
+// [first, head) are the samples still in the ring
+static uint64_t RingRange(uint64_t *first) {
+    uint64_t head = __atomic_load_n(&ringHead, __ATOMIC_ACQUIRE);
+    *first = head > PROF_RING_SIZE ? head - PROF_RING_SIZE : 0;
+    return head;
+}
+
+static int CompareU32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+void ProfSummarize(ProfStats out[PROF_PHASE_COUNT]) {
+    int count[PROF_PHASE_COUNT] = {0};
+    uint64_t first, head = RingRange(&first);
+    for (uint64_t i = first; i < head; ++i) {
+        const ProfSample *s = &ring[i & (PROF_RING_SIZE - 1)];
+        if (s->phase < PROF_PHASE_COUNT) sortBuf[s->phase][count[s->phase]++] = s->dur;
+    }
+
+    for (int p = 0; p < PROF_PHASE_COUNT; ++p) {
+        int n = count[p];
+        out[p] = (ProfStats){ n, 0.0, 0.0, 0.0 };
+        if (n == 0) continue;
+        qsort(sortBuf[p], (size_t)n, sizeof(uint32_t), CompareU32);
+        out[p].p50 = sortBuf[p][n / 2] * 1e-3;
+        out[p].p99 = sortBuf[p][(int)((n - 1) * 0.99)] * 1e-3;
+        out[p].max = sortBuf[p][n - 1] * 1e-3;
+    }
+}
+
+bool ProfWriteCsv(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "phase,start_ns,dur_ns\n");
+    uint64_t first, head = RingRange(&first);
+    for (uint64_t i = first; i < head; ++i) {
+        const ProfSample *s = &ring[i & (PROF_RING_SIZE - 1)];
+        fprintf(f, "%s,%llu,%u\n", ProfPhaseName((ProfPhase)s->phase), (unsigned long long)s->start, (unsigned)s->dur);
+    }
+    return fclose(f) == 0;
+}
+
+// "X" (complete) events, timestamps in microseconds relative to the oldest sample
+bool ProfWriteChromeTrace(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) return false;
+    uint64_t first, head = RingRange(&first);
+    uint64_t t0 = head > first ? ring[first & (PROF_RING_SIZE - 1)].start : 0;
+    fprintf(f, "{\"traceEvents\":[\n");
+    for (uint64_t i = first; i < head; ++i) {
+        const ProfSample *s = &ring[i & (PROF_RING_SIZE - 1)];
+        fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}\n",
+                i == first ? "" : ",", ProfPhaseName((ProfPhase)s->phase),
+                (double)(int64_t)(s->start - t0) * 1e-3, s->dur * 1e-3);
+    }
+    fprintf(f, "],\"displayTimeUnit\":\"ns\"}\n");
+    return fclose(f) == 0;
+}
@@ -0,0 +1,74 @@
+// NULL TERMINATOR — per-phase profiler
+// PROF_BEGIN / PROF_END around a phase record one sample (start + duration, ns) into a
+// ring buffer. Build with `make PROFILE=1` to turn them on; otherwise they compile to
+// nothing and the rest of the API just reports an empty profile.
+//
+// The ring is lock-free: writers grab a slot with one atomic add, so job threads could
+// record too. Older samples get overwritten, stats and exports cover whatever is left.
+
+#ifndef NT_PROF_H
+#define NT_PROF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+    PROF_FRAME = 0,          // whole frame, window builds only
+    PROF_INPUT,
+    PROF_TICK,               // one SimStep
+    PROF_SPAWN,
+    PROF_ROLLBACK,           // co-op: restore + re-simulate after a late input (includes those ticks)
+    PROF_UPDATE_BULLETS,
+    PROF_UPDATE_ENEMIES,
+    PROF_COLLIDE_BULLETS,
+    PROF_COLLIDE_PLAYER,
+    PROF_RENDER_BUILD,
+    PROF_PARTICLES,          // emit + update, window builds only
+    PROF_DRAW_TRACES,
+    PROF_DRAW_BULLETS,
+    PROF_DRAW_ENEMIES,
+    PROF_DRAW_PARTICLES,
+    PROF_DRAW_HUD,
+    PROF_HUD_REDRAW,         // re-rendering HUD layers, only on frames where they changed
+    PROF_DRAW_BANNERS,
+    PROF_PHASE_COUNT
+} ProfPhase;
+
+#define PROF_RING_SIZE 16384     // power of two
+
+typedef struct {
+    uint64_t start;          // ns, monotonic clock
+    uint32_t dur;            // ns
+    uint32_t phase;
+} ProfSample;
+
+typedef struct {
+    int count;               // samples of this phase still in the ring
+    double p50, p99, max;    // microseconds
+} ProfStats;
+
+#ifdef NT_PROFILE
+#define PROF_ENABLED 1
+#define PROF_BEGIN(phase)  uint64_t prof_t0_##phase = ProfNow()
+#define PROF_END(phase)    ProfRecord((phase), prof_t0_##phase, ProfNow())
+#else
+#define PROF_ENABLED 0
+#define PROF_BEGIN(phase)  ((void)0)
+#define PROF_END(phase)    ((void)0)
+#endif
+
+const char *ProfPhaseName(ProfPhase phase);
+
+uint64_t ProfNow(void);
+void ProfRecord(ProfPhase phase, uint64_t start, uint64_t end);
+void ProfClear(void);
+
+// one pass over the ring, p50/p99/max per phase. sorts scratch copies, call it a few
+// times a second at most, not per phase per frame
+void ProfSummarize(ProfStats out[PROF_PHASE_COUNT]);
+
+// every sample in the ring, oldest first. false if the file couldn't be written
+bool ProfWriteCsv(const char *path);
+bool ProfWriteChromeTrace(const char *path);    // chrome://tracing or ui.perfetto.dev
+
+#endif
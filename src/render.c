@@ -0,0 +1,102 @@
+// NULL TERMINATOR — render command list
+
+#include "render.h"
+#include "mem.h"
+#include <string.h>
+
+void RenderInit(RenderList *r) {
+    memset(r, 0, sizeof(*r));
+}
+
+void RenderFree(RenderList *r) {
+    for (int g = 0; g < RGROUP_COUNT; ++g) MemFree(r->groups[g].cmds);
+    memset(r, 0, sizeof(*r));
+}
+
+static bool Reserve(RenderGroup *g, int n) {
+    if (n <= g->capacity) return true;
+    int cap = g->capacity ? g->capacity : 256;
+    while (cap < n) cap *= 2;
+    RenderCmd *cmds = MemRealloc(MEM_RENDER, g->cmds, sizeof(RenderCmd) * (size_t)cap);
+    if (!cmds) return false;
+    g->cmds = cmds;
+    g->capacity = cap;
+    return true;
+}
+
+// does a box overlap the screen
+static bool OnScreen(float x0, float y0, float x1, float y1) {
+    return x1 >= 0.0f && y1 >= 0.0f && x0 <= SCREEN_W && y0 <= SCREEN_H;
+}
+
+static void AddCircle(RenderList *r, RenderGroup *g, float x, float y, float radius) {
+    if (!OnScreen(x - radius, y - radius, x + radius, y + radius)) { r->culled++; return; }
+    g->cmds[g->count++] = (RenderCmd){ x, y, x, y, radius };
+}
+
+// entities are blended from last tick's position to this one's
+static void AddPool(RenderList *r, RenderGroup *g, const EntityPool *p, float radius, float lerp, Vec2 cam) {
+    for (int c = 0; c < POOL_USED_CHUNKS(p); ++c) {
+        const PoolChunk *ch = p->chunks[c];
+        int n = POOL_CHUNK_COUNT(p, c);
+        for (int i = 0; i < n; ++i) {
+            float x = ch->px[i] + (ch->x[i] - ch->px[i]) * lerp + cam.x;
+            float y = ch->py[i] + (ch->y[i] - ch->py[i]) * lerp + cam.y;
+            AddCircle(r, g, x, y, radius);
+        }
+    }
+}
+
+bool RenderBuild(RenderList *r, const GameState *s, float lerp, Vec2 cam) {
+    RenderGroup *traces = &r->groups[RGROUP_TRACES], *flashes = &r->groups[RGROUP_FLASHES];
+    RenderGroup *bullets = &r->groups[RGROUP_BULLETS], *enemies = &r->groups[RGROUP_ENEMIES];
+    r->culled = 0;
+    for (int g = 0; g < RGROUP_COUNT; ++g) r->groups[g].count = 0;
+    if (!Reserve(traces, s->traces.count) || !Reserve(flashes, s->traces.count) ||
+        !Reserve(bullets, s->bullets.count) || !Reserve(enemies, s->enemies.count)) return false;
+
+    for (int i = 0; i < s->traces.count; ++i) {
+        const ShotTrace *tr = ChunkListAt(&s->traces, i);
+        float t = tr->life / TRACE_LIFE;    // 1 -> 0
+        float ax = tr->a.x + cam.x, ay = tr->a.y + cam.y;
+        float bx = tr->b.x + cam.x, by = tr->b.y + cam.y;
+        float thick = 3.0f * t + 1.0f;
+        float pad = thick * 0.5f;
+        if (OnScreen((ax < bx ? ax : bx) - pad, (ay < by ? ay : by) - pad,
+                     (ax > bx ? ax : bx) + pad, (ay > by ? ay : by) + pad)) {
+            traces->cmds[traces->count++] = (RenderCmd){ ax, ay, bx, by, thick };
+        } else {
+            r->culled++;
+        }
+        AddCircle(r, flashes, ax, ay, 4.0f * t + 1.0f);     // muzzle flash
+    }
+
+    AddPool(r, bullets, &s->bullets, BULLET_RADIUS, lerp, cam);
+    AddPool(r, enemies, &s->enemies, ENEMY_RADIUS, lerp, cam);
+    return true;
+}
+
+bool RenderAddParticles(RenderList *r, const ParticleSystem *ps, Vec2 cam) {
+    RenderGroup *g = &r->groups[RGROUP_PARTICLES];
+    g->count = 0;
+    if (!Reserve(g, ParticlesLive(ps))) return false;
+    for (uint32_t n = ps->tail; n != ps->head; ++n) {
+        uint32_t i = n & (PARTICLE_CAP - 1);
+        if (ps->life[i] <= 0.0f) continue;
+        AddCircle(r, g, ps->x[i] + cam.x, ps->y[i] + cam.y, ps->life[i] * ps->shrink[i]);
+    }
+    return true;
+}
+
+int RenderCommandCount(const RenderList *r) {
+    int n = 0;
+    for (int g = 0; g < RGROUP_COUNT; ++g) n += r->groups[g].count;
+    return n;
+}
+
+int RenderDrawCalls(const RenderList *r) {
+    int calls = 0;
+    for (int g = 0; g < RGROUP_COUNT; ++g)
+        calls += (r->groups[g].count + RENDER_BATCH_QUADS - 1) / RENDER_BATCH_QUADS;
+    return calls;
+}
@@ -0,0 +1,61 @@
+// NULL TERMINATOR — render command list
+// The sim-to-render step: turns a GameState into flat lists of screen-space shapes,
+// already interpolated, shaken and culled, one list per kind of thing on screen.
+// The window build then submits each list as one batch (circles are a pre-baked
+// sprite drawn as textured quads). No raylib in here, so headless code can build the
+// same lists and check the counts.
+
+#ifndef NT_RENDER_H
+#define NT_RENDER_H
+
+#include "sim.h"
+#include "particles.h"
+
+// draw order, back to front
+typedef enum {
+    RGROUP_TRACES = 0,       // lines
+    RGROUP_FLASHES,          // circles (muzzle flash at the start of each trace)
+    RGROUP_BULLETS,          // circles
+    RGROUP_ENEMIES,          // circles
+    RGROUP_PARTICLES,        // circles, filled by RenderAddParticles
+    RGROUP_COUNT
+} RenderGroupId;
+
+// quads per submitted batch, same as rlgl's default batch buffer
+// (more than this in one group means an extra draw call per 8192)
+#define RENDER_BATCH_QUADS 8192
+
+// one shape in screen space. circles: (x0, y0) center, size = radius.
+// lines: (x0, y0) -> (x1, y1), size = thickness
+typedef struct {
+    float x0, y0, x1, y1;
+    float size;
+} RenderCmd;
+
+typedef struct {
+    RenderCmd *cmds;
+    int count, capacity;
+} RenderGroup;
+
+typedef struct {
+    RenderGroup groups[RGROUP_COUNT];
+    int culled;              // shapes skipped by the last build for being off screen
+} RenderList;
+
+void RenderInit(RenderList *r);
+void RenderFree(RenderList *r);
+
+// rebuild from s. lerp = how far we are into the next tick (0..1), cam = shake offset.
+// grows the lists when needed (kept between frames), false if that failed
+bool RenderBuild(RenderList *r, const GameState *s, float lerp, Vec2 cam);
+
+// particles into their own group, after RenderBuild (which empties it). they move
+// with the frame, not the tick, so there's nothing to interpolate
+bool RenderAddParticles(RenderList *r, const ParticleSystem *ps, Vec2 cam);
+
+int RenderCommandCount(const RenderList *r);
+
+// batches the submit will issue: one per RENDER_BATCH_QUADS shapes of each non-empty group
+int RenderDrawCalls(const RenderList *r);
+
+#endif
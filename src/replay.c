@@ -0,0 +1,215 @@
+// NULL TERMINATOR — input replays
+
+#include "replay.h"
+#include "mem.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum { REC_FIRE = 1, REC_RESTART = 2, REC_AIM = 4, REC_AIM_DELTA = 8, REC_END = 0xFF };
+
+Vec2 ReplaySnapAim(Vec2 aim) {
+    return (Vec2){ roundf(aim.x * REPLAY_AIM_SUBPX) / REPLAY_AIM_SUBPX,
+                   roundf(aim.y * REPLAY_AIM_SUBPX) / REPLAY_AIM_SUBPX };
+}
+
+// aim in 1/16 px units, false if it's off the grid (or silly far off screen)
+static bool AimUnits(float v, int32_t *out) {
+    float u = v * REPLAY_AIM_SUBPX;
+    if (!(u > -1e6f && u < 1e6f) || u != (float)(int32_t)u) return false;
+    *out = (int32_t)u;
+    return true;
+}
+
+static uint32_t ZigZag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+static int32_t UnZigZag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+static void PutU8(FILE *f, unsigned v) { fputc((int)(v & 0xFF), f); }
+
+static void PutLE(FILE *f, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) PutU8(f, (unsigned)(v >> (8 * i)));
+}
+
+static void PutVarint(FILE *f, uint32_t v) {
+    while (v >= 0x80) { PutU8(f, (v & 0x7F) | 0x80); v >>= 7; }
+    PutU8(f, v);
+}
+
+static void PutF32(FILE *f, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    PutLE(f, bits, 4);
+}
+
+bool ReplayWriterOpen(ReplayWriter *w, const char *path, uint64_t seed, int hz, int highScore) {
+    memset(w, 0, sizeof(*w));
+    w->f = fopen(path, "wb");
+    if (!w->f) return false;
+    fwrite("NTRP", 1, 4, w->f);
+    PutLE(w->f, REPLAY_VERSION, 2);
+    PutLE(w->f, (uint64_t)hz, 2);
+    PutLE(w->f, seed, 8);
+    PutLE(w->f, (uint32_t)highScore, 4);
+    return true;
+}
+
+void ReplayWriterTick(ReplayWriter *w, const SimInput *in) {
+    if (!w->f) return;
+    bool aimChanged = !w->any || in->aim.x != w->last.aim.x || in->aim.y != w->last.aim.y;
+    if (w->any && !aimChanged && in->fire == w->last.fire && in->restart == w->last.restart) {
+        w->ticks++;
+        return;
+    }
+
+    // both aims on the 1/16 grid: store the difference, otherwise the raw floats
+    int32_t ux, uy, lx = 0, ly = 0;
+    bool delta = aimChanged && AimUnits(in->aim.x, &ux) && AimUnits(in->aim.y, &uy) &&
+                 (!w->any || (AimUnits(w->last.aim.x, &lx) && AimUnits(w->last.aim.y, &ly)));
+
+    unsigned flags = (in->fire ? REC_FIRE : 0) | (in->restart ? REC_RESTART : 0) |
+                     (aimChanged ? (delta ? REC_AIM_DELTA : REC_AIM) : 0);
+    PutVarint(w->f, w->any ? w->ticks - w->lastRecord : 0);
+    PutU8(w->f, flags);
+    if (delta) {
+        PutVarint(w->f, ZigZag(ux - lx));
+        PutVarint(w->f, ZigZag(uy - ly));
+    } else if (aimChanged) {
+        PutF32(w->f, in->aim.x);
+        PutF32(w->f, in->aim.y);
+    }
+
+    w->last = *in;
+    w->lastRecord = w->ticks;
+    w->any = true;
+    w->ticks++;
+}
+
+void ReplayTickHook(void *user, const GameState *s, const SimInput *in) {
+    (void)s;
+    ReplayWriterTick((ReplayWriter *)user, in);
+}
+
+bool ReplayWriterClose(ReplayWriter *w, const GameState *final) {
+    if (!w->f) return false;
+    PutVarint(w->f, 0);
+    PutU8(w->f, REC_END);
+    PutLE(w->f, w->ticks, 4);
+    PutLE(w->f, (uint32_t)final->score, 4);
+    PutLE(w->f, SimHash(final), 8);
+    bool ok = !ferror(w->f);
+    if (fclose(w->f) != 0) ok = false;
+    w->f = NULL;
+    return ok;
+}
+
+
+// reading: everything bounds-checked, a truncated file just fails to load
+
+static bool GetU8(Replay *r, unsigned *v) {
+    if (r->pos >= r->size) return false;
+    *v = r->data[r->pos++];
+    return true;
+}
+
+static bool GetLE(Replay *r, uint64_t *v, int bytes) {
+    if (r->size - r->pos < (size_t)bytes) return false;
+    *v = 0;
+    for (int i = 0; i < bytes; ++i) *v |= (uint64_t)r->data[r->pos++] << (8 * i);
+    return true;
+}
+
+static bool GetVarint(Replay *r, uint32_t *v) {
+    *v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        unsigned b;
+        if (!GetU8(r, &b)) return false;
+        *v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static bool GetF32(Replay *r, float *v) {
+    uint64_t bits;
+    if (!GetLE(r, &bits, 4)) return false;
+    uint32_t b32 = (uint32_t)bits;
+    memcpy(v, &b32, sizeof(*v));
+    return true;
+}
+
+// reads the delta in front of the next record and works out which tick it applies to
+static bool ReadNextDelta(Replay *r, uint32_t from) {
+    uint32_t delta;
+    if (!GetVarint(r, &delta)) return false;
+    if (r->pos < r->size && r->data[r->pos] == REC_END) {
+        r->nextChange = UINT32_MAX;      // input stays as is until the last tick
+        return true;
+    }
+    r->nextChange = from + delta;
+    return true;
+}
+
+static bool ApplyRecord(Replay *r) {
+    unsigned flags;
+    if (!GetU8(r, &flags)) return false;
+    r->cur.fire = (flags & REC_FIRE) != 0;
+    r->cur.restart = (flags & REC_RESTART) != 0;
+    if (flags & REC_AIM) return GetF32(r, &r->cur.aim.x) && GetF32(r, &r->cur.aim.y);
+    if (flags & REC_AIM_DELTA) {
+        // previous aim is on the grid by construction (a first record starts from 0,0)
+        uint32_t dx, dy;
+        if (!GetVarint(r, &dx) || !GetVarint(r, &dy)) return false;
+        int32_t ux = (int32_t)(r->cur.aim.x * REPLAY_AIM_SUBPX) + UnZigZag(dx);
+        int32_t uy = (int32_t)(r->cur.aim.y * REPLAY_AIM_SUBPX) + UnZigZag(dy);
+        r->cur.aim = (Vec2){ (float)ux / REPLAY_AIM_SUBPX, (float)uy / REPLAY_AIM_SUBPX };
+    }
+    return true;
+}
+
+bool ReplayLoad(Replay *r, const char *path) {
+    memset(r, 0, sizeof(*r));
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size < 20 + 2 + 16) { fclose(f); return false; }   // header + end marker + footer
+    r->data = MemAlloc(MEM_IO, (size_t)size);
+    r->size = (size_t)size;
+    bool ok = r->data && fread(r->data, 1, r->size, f) == r->size;
+    fclose(f);
+    if (!ok || memcmp(r->data, "NTRP", 4) != 0) { ReplayFree(r); return false; }
+
+    // footer is the last 16 bytes, the records must not run into it
+    uint64_t v;
+    r->pos = r->size - 16;
+    GetLE(r, &v, 4); r->ticks = (uint32_t)v;
+    GetLE(r, &v, 4); r->finalScore = (int)(uint32_t)v;
+    GetLE(r, &v, 8); r->finalHash = v;
+    r->size -= 16;
+
+    r->pos = 4;
+    GetLE(r, &v, 2); r->version = (int)v;
+    GetLE(r, &v, 2); r->hz = (int)v;
+    GetLE(r, &v, 8); r->seed = v;
+    GetLE(r, &v, 4); r->highScore = (int)(uint32_t)v;
+    if (r->version != REPLAY_VERSION || r->hz <= 0 || !ReadNextDelta(r, 0)) {
+        ReplayFree(r);
+        return false;
+    }
+    return true;
+}
+
+void ReplayFree(Replay *r) {
+    MemFree(r->data);
+    r->data = NULL;
+    r->size = r->pos = 0;
+}
+
+bool ReplayNext(Replay *r, SimInput *in) {
+    if (r->tick >= r->ticks) return false;
+    if (r->tick == r->nextChange && (!ApplyRecord(r) || !ReadNextDelta(r, r->tick))) return false;
+    *in = r->cur;
+    r->tick++;
+    return true;
+}
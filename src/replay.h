@@ -0,0 +1,68 @@
+// NULL TERMINATOR — input replays
+// A replay is the seed plus every tick's input, run-length encoded: a record is only
+// written when the input changes. Playing one back through SimStep rebuilds the run
+// bit for bit, and the footer (final tick, score, SimHash) says whether it did.
+//
+// file layout, all little-endian:
+//   "NTRP"  u16 version  u16 hz  u64 seed  i32 starting high score
+//   records: varint ticks-since-last-record, u8 flags (1 fire, 2 restart, 4 raw aim, 8 aim delta)
+//            raw aim:   f32 aim.x  f32 aim.y
+//            aim delta: zigzag varint dx, dy in 1/16 px from the previous aim
+//                       (used whenever the aim sits on that grid, see ReplaySnapAim)
+//   end:     varint 0, u8 0xFF, u32 ticks  i32 final score  u64 final SimHash
+
+#ifndef NT_REPLAY_H
+#define NT_REPLAY_H
+
+#include "sim.h"
+#include <stdio.h>
+
+#define REPLAY_VERSION 1
+#define REPLAY_AIM_SUBPX 16
+
+// snap an aim point to the 1/16 px grid so its record is a couple of bytes, not 8.
+// whoever records has to feed the snapped value to the sim too
+Vec2 ReplaySnapAim(Vec2 aim);
+
+typedef struct {
+    FILE *f;
+    uint32_t ticks;          // inputs written so far
+    uint32_t lastRecord;     // tick of the last record
+    SimInput last;
+    bool any;                // no record yet, the first tick always writes one
+} ReplayWriter;
+
+bool ReplayWriterOpen(ReplayWriter *w, const char *path, uint64_t seed, int hz, int highScore);
+void ReplayWriterTick(ReplayWriter *w, const SimInput *in);     // once per SimStep, in order
+bool ReplayWriterClose(ReplayWriter *w, const GameState *final);
+
+// fits SimClock.onTick (user = ReplayWriter*)
+void ReplayTickHook(void *user, const GameState *s, const SimInput *in);
+
+typedef struct {
+    unsigned char *data;
+    size_t size, pos;
+
+    // header
+    int version, hz, highScore;
+    uint64_t seed;
+
+    // footer (what the recording ended on)
+    uint32_t ticks;
+    int finalScore;
+    uint64_t finalHash;
+
+    // playback cursor
+    uint32_t tick;           // next tick to hand out
+    uint32_t nextChange;     // tick the next record applies to
+    SimInput cur;
+} Replay;
+
+// reads and validates the whole file (small: a few bytes per input change)
+bool ReplayLoad(Replay *r, const char *path);
+void ReplayFree(Replay *r);
+
+// input for the next tick, false once all recorded ticks are used up
+bool ReplayNext(Replay *r, SimInput *in);
+
+#endif
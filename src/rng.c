@@ -0,0 +1,31 @@
+// NULL TERMINATOR — seeded random numbers
+
+#include "rng.h"
+
+void RngSeed(Rng *r, uint64_t seed) {
+    // splitmix64 scramble so small seeds (0, 1, 2...) still start far apart
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    r->state = z ? z : 0x2545F4914F6CDD1Dull;   // xorshift must never sit at 0
+}
+
+uint32_t RngNext(Rng *r) {
+    uint64_t x = r->state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    r->state = x;
+    return (uint32_t)((x * 0x2545F4914F6CDD1Dull) >> 32);
+}
+
+int RngRange(Rng *r, int min, int max) {
+    if (max < min) { int t = min; min = max; max = t; }
+    uint32_t span = (uint32_t)(max - min) + 1u;
+    return min + (int)(RngNext(r) % span);
+}
+
+float RngFloat(Rng *r) {
+    return (float)(RngNext(r) >> 8) * (1.0f / 16777216.0f);
+}
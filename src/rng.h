@@ -0,0 +1,19 @@
+// NULL TERMINATOR — seeded random numbers
+// Small xorshift64* generator. The sim owns one, so a seed plus the inputs fully
+// decides a run (no more global GetRandomValue state).
+
+#ifndef NT_RNG_H
+#define NT_RNG_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t state;
+} Rng;
+
+void     RngSeed(Rng *r, uint64_t seed);
+uint32_t RngNext(Rng *r);
+int      RngRange(Rng *r, int min, int max);   // inclusive, like GetRandomValue
+float    RngFloat(Rng *r);                     // [0, 1)
+
+#endif
@@ -0,0 +1,177 @@
+// NULL TERMINATOR — high scores
+
+#define _POSIX_C_SOURCE 200112L
+#include "scores.h"
+#include "mem.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static void PutLE(unsigned char *p, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static uint64_t GetLE(const unsigned char *p, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+bool LeaderboardLoad(Leaderboard *lb, const char *path) {
+    memset(lb, 0, sizeof(*lb));
+    unsigned char buf[SCORES_FILE_BYTES];
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    size_t got = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    if (got != sizeof(buf) || memcmp(buf, "NTHS", 4) != 0 || GetLE(buf + 4, 2) != SCORES_VERSION) return false;
+
+    int count = (int)GetLE(buf + 6, 2);
+    if (count > SCORES_TOP_N) return false;
+    for (int i = 0; i < count; ++i) {
+        const unsigned char *p = buf + 8 + i * 16;
+        uint32_t bits = (uint32_t)GetLE(p + 4, 4);
+        ScoreEntry *e = &lb->entries[i];
+        e->score = (int32_t)GetLE(p, 4);
+        memcpy(&e->duration, &bits, sizeof(bits));
+        e->timestamp = (int64_t)GetLE(p + 8, 8);
+    }
+    lb->count = count;
+    return true;
+}
+
+// a rename is only on disk once the directory holding it is. best effort: where a
+// directory can't be opened or fsynced the new file is in place, just not as durably
+static void SyncDir(const char *path) {
+    char dir[sizeof(((ScoreWriter *)0)->path)];
+    const char *slash = strrchr(path, '/');
+    size_t n = slash ? (slash == path ? 1 : (size_t)(slash - path)) : 0;
+    if (n >= sizeof(dir)) return;
+    if (n) memcpy(dir, path, n);
+    else dir[n++] = '.';
+    dir[n] = '\0';
+
+    int fd = open(dir, O_RDONLY);
+    if (fd < 0) return;
+    fsync(fd);
+    close(fd);
+}
+
+bool LeaderboardSave(const Leaderboard *lb, const char *path) {
+    unsigned char buf[SCORES_FILE_BYTES] = {0};
+    memcpy(buf, "NTHS", 4);
+    PutLE(buf + 4, SCORES_VERSION, 2);
+    PutLE(buf + 6, (uint64_t)lb->count, 2);
+    for (int i = 0; i < lb->count; ++i) {
+        unsigned char *p = buf + 8 + i * 16;
+        uint32_t bits;
+        memcpy(&bits, &lb->entries[i].duration, sizeof(bits));
+        PutLE(p, (uint32_t)lb->entries[i].score, 4);
+        PutLE(p + 4, bits, 4);
+        PutLE(p + 8, (uint64_t)lb->entries[i].timestamp, 8);
+    }
+
+    // the old file stays untouched until the new one is fully on disk
+    char tmp[sizeof(((ScoreWriter *)0)->path) + 4];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp)) return false;
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    bool ok = write(fd, buf, sizeof(buf)) == (ssize_t)sizeof(buf) && fsync(fd) == 0;
+    ok = close(fd) == 0 && ok;
+    if (!ok || rename(tmp, path) != 0) {
+        unlink(tmp);
+        return false;
+    }
+    SyncDir(path);
+    return true;
+}
+
+int LeaderboardInsert(Leaderboard *lb, ScoreEntry e) {
+    int rank = lb->count;
+    while (rank > 0 && lb->entries[rank - 1].score < e.score) rank--;
+    if (rank >= SCORES_TOP_N) return -1;
+
+    int last = lb->count < SCORES_TOP_N ? lb->count : SCORES_TOP_N - 1;
+    memmove(&lb->entries[rank + 1], &lb->entries[rank], sizeof(ScoreEntry) * (size_t)(last - rank));
+    lb->entries[rank] = e;
+    if (lb->count < SCORES_TOP_N) lb->count++;
+    return rank;
+}
+
+int LeaderboardBest(const Leaderboard *lb) {
+    return lb->count > 0 ? lb->entries[0].score : 0;
+}
+
+
+static void *WriterMain(void *arg) {
+    ScoreWriter *w = arg;
+    pthread_mutex_lock(&w->lock);
+    for (;;) {
+        while (w->count == 0 && !w->quit) pthread_cond_wait(&w->wake, &w->lock);
+        if (w->count == 0) break;    // quit and nothing left
+
+        // take everything queued in one go, so a burst of runs is one write
+        bool changed = false;
+        while (w->count > 0) {
+            changed |= LeaderboardInsert(&w->board, w->queue[w->head]) >= 0;
+            w->head = (w->head + 1) % SCORES_QUEUE;
+            w->count--;
+        }
+        if (!changed) continue;
+        Leaderboard snapshot = w->board;
+        pthread_mutex_unlock(&w->lock);
+
+        bool ok = LeaderboardSave(&snapshot, w->path);
+
+        pthread_mutex_lock(&w->lock);
+        if (ok) w->saves++;
+        else w->failures++;
+    }
+    pthread_mutex_unlock(&w->lock);
+    return NULL;
+}
+
+bool ScoreWriterStart(ScoreWriter *w, const char *path, const Leaderboard *board) {
+    memset(w, 0, sizeof(*w));
+    if (board) w->board = *board;
+    if (snprintf(w->path, sizeof(w->path), "%s", path) >= (int)sizeof(w->path)) return false;
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->wake, NULL);
+    w->running = pthread_create(&w->thread, NULL, WriterMain, w) == 0;
+    if (w->running) MemNoteHeld(MEM_IO, sizeof(w->queue));
+    return w->running;
+}
+
+bool ScoreWriterSubmit(ScoreWriter *w, ScoreEntry e) {
+    if (!w->running) {
+        // no thread: the rare box that can't start one pays for the write itself
+        if (LeaderboardInsert(&w->board, e) < 0) return true;
+        if (LeaderboardSave(&w->board, w->path)) w->saves++;
+        else w->failures++;
+        return true;
+    }
+
+    pthread_mutex_lock(&w->lock);
+    bool queued = w->count < SCORES_QUEUE;
+    if (queued) {
+        w->queue[(w->head + w->count) % SCORES_QUEUE] = e;
+        w->count++;
+        pthread_cond_signal(&w->wake);
+    } else {
+        w->dropped++;
+    }
+    pthread_mutex_unlock(&w->lock);
+    return queued;
+}
+
+void ScoreWriterStop(ScoreWriter *w) {
+    if (!w->running) return;
+    pthread_mutex_lock(&w->lock);
+    w->quit = true;
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->thread, NULL);
+    w->running = false;
+    MemNoteHeld(MEM_IO, -(int64_t)sizeof(w->queue));
+}
@@ -0,0 +1,76 @@
+// NULL TERMINATOR — high scores
+// Top-N leaderboard (score, run length, when) in a small fixed-size binary file.
+// Fixed size means loading is one read of SCORES_FILE_BYTES no matter how many runs
+// have been played.
+//
+// Saving never happens on the game thread: ScoreWriter owns an I/O thread that takes
+// finished runs off a queue, merges them into its copy of the board and rewrites the
+// file as temp + fsync + rename + directory fsync, so a crash or power loss mid-write
+// leaves the old file intact.
+//
+// file layout, all little-endian:
+//   "NTHS"  u16 version  u16 count
+//   SCORES_TOP_N x { i32 score  f32 duration (s)  i64 unix time }   best first, unused ones zeroed
+
+#ifndef NT_SCORES_H
+#define NT_SCORES_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SCORES_VERSION 1
+#define SCORES_TOP_N   10
+#define SCORES_QUEUE   64        // runs waiting for the writer, more than that get dropped
+#define SCORES_FILE_BYTES (8 + SCORES_TOP_N * 16)
+
+typedef struct {
+    int32_t score;
+    float duration;          // seconds survived
+    int64_t timestamp;       // unix time the run ended
+} ScoreEntry;
+
+typedef struct {
+    int count;
+    ScoreEntry entries[SCORES_TOP_N];    // best first; ties keep the older run ahead
+} Leaderboard;
+
+// false (and an empty board) if the file is missing or isn't a leaderboard
+bool LeaderboardLoad(Leaderboard *lb, const char *path);
+
+// blocking write through path.tmp + fsync + rename, then fsyncs the directory. the
+// writer thread uses this
+bool LeaderboardSave(const Leaderboard *lb, const char *path);
+
+// returns the rank it landed at, or -1 if it didn't make the board
+int LeaderboardInsert(Leaderboard *lb, ScoreEntry e);
+
+int LeaderboardBest(const Leaderboard *lb);     // 0 when empty
+
+
+typedef struct {
+    pthread_t thread;
+    bool running;            // false: thread didn't start, submissions are saved inline
+
+    pthread_mutex_t lock;    // guards everything below
+    pthread_cond_t wake;
+    ScoreEntry queue[SCORES_QUEUE];
+    int head, count;
+    bool quit;
+
+    Leaderboard board;       // the writer's copy, what the file will hold
+    char path[256];
+    int saves, failures, dropped;
+} ScoreWriter;
+
+// board is what's already on disk (usually straight from LeaderboardLoad)
+bool ScoreWriterStart(ScoreWriter *w, const char *path, const Leaderboard *board);
+
+// hand a finished run to the I/O thread. only takes the queue lock, never waits on
+// disk. false if the queue was full and the run got dropped
+bool ScoreWriterSubmit(ScoreWriter *w, ScoreEntry e);
+
+// writes whatever is still queued, then joins the thread
+void ScoreWriterStop(ScoreWriter *w);
+
+#endif
@@ -0,0 +1,796 @@
+// NULL TERMINATOR — simulation core
+// Pulled out of the old main() loop. Same rules, same order, just no raylib.
+
+#include "sim.h"
+#include "fixed.h"
+#include "jobs.h"
+#include "kernels.h"
+#include "prof.h"
+#include "telemetry.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// direction math. FIXED=1 builds do it in 16.16 (src/fixed.h) so every machine gets
+// the same bits; the float versions are what the game has always run
+#ifdef NT_FIXED
+typedef int32_t Angle;          // binary angle, 65536 per turn
+
+// unit vector along (dx, dy), false (and zero) if it's too short to have a direction
+static bool UnitDir(float dx, float dy, Vec2 *out) {
+    Fixed x = FxFromFloat(dx), y = FxFromFloat(dy);
+    if (!FxNormalize(&x, &y)) { *out = (Vec2){0}; return false; }
+    *out = (Vec2){ FxToFloat(x), FxToFloat(y) };
+    return true;
+}
+static Angle AngleFromDeg(float deg)     { return FxAngleFromDeg(deg); }
+static Vec2 AngleDir(Angle a)            { return (Vec2){ FxToFloat(FxCos((uint16_t)a)), FxToFloat(FxSin((uint16_t)a)) }; }
+
+// i-th of n angles fanned evenly over base +- spread
+static Angle FanAngle(Angle base, Angle spread, int i, int n) {
+    if (n == 1) return base;
+    return base + (2 * i - (n - 1)) * spread / (n - 1);
+}
+
+// v = speed toward `at` for a run of entities
+static void AimRun(const float *x, const float *y, float *vx, float *vy, int n, Vec2 at, float speed) {
+    for (int i = 0; i < n; ++i) {
+        Vec2 d;
+        UnitDir(at.x - x[i], at.y - y[i], &d);
+        vx[i] = d.x * speed;
+        vy[i] = d.y * speed;
+    }
+}
+#else
+typedef float Angle;
+
+static bool UnitDir(float dx, float dy, Vec2 *out) {
+    float len = sqrtf(dx*dx + dy*dy);
+    if (len <= 0.0001f) { *out = (Vec2){0}; return false; }
+    *out = (Vec2){ dx / len, dy / len };
+    return true;
+}
+static Angle AngleFromDeg(float deg)     { return deg * (SIM_PI/180.0f); }
+static Vec2 AngleDir(Angle a)            { return (Vec2){ cosf(a), sinf(a) }; }
+
+static Angle FanAngle(Angle base, Angle spread, int i, int n) {
+    float t = (n == 1) ? 0.0f : (float)i/(float)(n-1);      // 0..1
+    return base + (t - 0.5f) * 2.0f * spread;               // center→edges
+}
+
+static void AimRun(const float *x, const float *y, float *vx, float *vy, int n, Vec2 at, float speed) {
+    KernelAimAt(x, y, vx, vy, n, at.x, at.y, speed);
+}
+#endif
+
+
+static void AddFx(GameState *s, SimFxKind kind, Vec2 pos, float dx, float dy) {
+    Vec2 dir;
+    UnitDir(dx, dy, &dir);
+    s->fx[s->fxCount++ & (SIM_FX_RING - 1)] = (SimFx){ pos, dir, kind };
+}
+
+// enemy ei eaten by bullet bi (both still in their pools)
+static void NoteKill(GameState *s, int ei, int bi, float t) {
+    // where the two met, t seconds into the step
+    Vec2 at = { POOL_GET(&s->enemies, x, ei) + POOL_GET(&s->enemies, vx, ei) * t,
+                POOL_GET(&s->enemies, y, ei) + POOL_GET(&s->enemies, vy, ei) * t };
+    float vx = POOL_GET(&s->bullets, vx, bi), vy = POOL_GET(&s->bullets, vy, bi);
+    AddFx(s, SIM_FX_KILL, at, vx, vy);
+    if (s->telemetry)
+        TelemetryKill(s->telemetry, s->tick, at.x, at.y, POOL_GET(&s->bullets, x, bi) + vx * t,
+                      POOL_GET(&s->bullets, y, bi) + vy * t, vx, vy);
+}
+
+
+// helper function to add traces
+static void AddTrace(GameState *s, Vec2 a, Vec2 b) {
+    ShotTrace *t = ChunkListPush(&s->traces);
+    if (t) *t = (ShotTrace){ a, b, TRACE_LIFE };  // short-lived flash
+}
+
+
+// helper to update and remove expired traces
+static void UpdateTraces(GameState *s, float dt) {
+    for (int i = s->traces.count - 1; i >= 0; --i) {
+        ShotTrace *t = ChunkListAt(&s->traces, i);
+        t->life -= dt;
+        if (t->life <= 0.0f) ChunkListRemove(&s->traces, i);   // remove by swap
+    }
+}
+
+// PoolUpdate with the chunk stepping spread over the job threads. the removals stay
+// on this thread, back to front, so the result doesn't depend on the thread count
+typedef struct {
+    EntityPool *pool;
+    float dt, margin;
+    bool withLife;
+    int dead;
+} StepJob;
+
+static void StepJobRun(void *user, int c0, int c1) {
+    StepJob *j = user;
+    int dead = PoolStepChunks(j->pool, c0, c1, j->dt, j->withLife,
+                              -j->margin, -j->margin, SCREEN_W + j->margin, SCREEN_H + j->margin);
+    if (dead) __atomic_add_fetch(&j->dead, dead, __ATOMIC_RELAXED);
+}
+
+static void UpdatePool(GameState *s, EntityPool *p, float dt, bool withLife, float margin) {
+    StepJob j = { p, dt, margin, withLife, 0 };
+    JobsParallelFor(s->jobs, POOL_USED_CHUNKS(p), 1, StepJobRun, &j);
+    if (j.dead > 0) PoolRemoveMarked(p);
+}
+
+// kill if expired or off-screen
+static void UpdateBullets(GameState *s, float dt) {
+    UpdatePool(s, &s->bullets, dt, true, 20);
+}
+
+// co-op: each enemy heads for whichever gunner is closer when it spawns
+static void AimNearest(const GameState *s, const float *x, const float *y, float *vx, float *vy, int n, float speed) {
+    for (int i = 0; i < n; ++i) {
+        Vec2 to = s->player[0];
+        float best = 1e30f;
+        for (int k = 0; k < s->players; ++k) {
+            float dx = s->player[k].x - x[i], dy = s->player[k].y - y[i];
+            if (dx*dx + dy*dy < best) { best = dx*dx + dy*dy; to = s->player[k]; }
+        }
+        AimRun(x + i, y + i, vx + i, vy + i, 1, to, speed);
+    }
+}
+
+// n enemies in one go: a single PoolPushN, then positions copied out of the spawn
+// stream and velocities aimed at the player a run at a time (a run ends at a pool
+// chunk or stream block edge)
+static int SpawnEnemies(GameState *s, int n, float speed) {
+    EntityPool *p = &s->enemies;
+    int got;
+    int i = PoolPushN(p, n, &got), end = i + got;
+    while (i < end) {
+        const float *sx, *sy;
+        int run = SpawnStreamAt(&s->spawnStream, s->seed, s->spawnIndex, &sx, &sy);
+        int l = POOL_LANE(i);
+        if (run > POOL_CHUNK_SIZE - l) run = POOL_CHUNK_SIZE - l;
+        if (run > end - i) run = end - i;
+
+        PoolChunk *ch = POOL_CHUNK(p, i);
+        memcpy(ch->x + l, sx, sizeof(float) * (size_t)run);
+        memcpy(ch->y + l, sy, sizeof(float) * (size_t)run);
+        memcpy(ch->px + l, sx, sizeof(float) * (size_t)run);     // nothing to blend from yet
+        memcpy(ch->py + l, sy, sizeof(float) * (size_t)run);
+        memset(ch->life + l, 0, sizeof(float) * (size_t)run);
+        if (s->players == 1) AimRun(ch->x + l, ch->y + l, ch->vx + l, ch->vy + l, run, s->player[0], speed);
+        else AimNearest(s, ch->x + l, ch->y + l, ch->vx + l, ch->vy + l, run, speed);
+
+        s->spawnIndex += (uint64_t)run;
+        i += run;
+    }
+    if (s->telemetry && got > 0) TelemetrySpawn(s->telemetry, s->tick, got);
+    return got;
+}
+
+static float EnemySpeed(const GameState *s) {
+    float speed = s->tune.enemySpeedBase + s->tune.enemySpeedRamp * s->timeSinceStart;
+    return speed > s->tune.enemySpeedMax ? s->tune.enemySpeedMax : speed;
+}
+
+int SimSpawnEnemies(GameState *s, int n) {
+    return n > 0 ? SpawnEnemies(s, n, EnemySpeed(s)) : 0;
+}
+
+
+static void UpdateEnemies(GameState *s, float dt) {
+    UpdatePool(s, &s->enemies, dt, false, 50);
+}
+
+// a fan's pellet directions, one sin/cos each (libm, or the fixed tables in FIXED=1)
+static void BuildFan(WeaponFan *fan, int pellets, float spreadDeg) {
+    Angle spread = AngleFromDeg(spreadDeg);
+    for (int i = 0; i < pellets; ++i) {
+        Vec2 d = AngleDir(FanAngle(0, spread, i, pellets));
+        fan->c[i] = d.x;
+        fan->s[i] = d.y;
+    }
+    fan->pellets = pellets;
+    fan->spreadDeg = spreadDeg;
+}
+
+// pellets bullets fanned over +-spreadDeg around the aim: one normalize for the aim,
+// then each pellet is it rotated by a fan entry (no trig per shot), written into the
+// pool a chunk run at a time
+static void FireFan(GameState *s, WeaponFan *fan, Vec2 from, Vec2 aim, int pellets, float spreadDeg,
+                    float speed, float life, bool blast) {
+    Vec2 d;
+    bool aimed = UnitDir(aim.x - from.x, aim.y - from.y, &d);
+    if (blast) {
+        AddFx(s, SIM_FX_SHOTGUN, from, aim.x - from.x, aim.y - from.y);
+        AddTrace(s, from, (Vec2){ from.x + d.x, from.y + d.y });    // one bright center trace for feedback
+    } else {
+        AddTrace(s, from, aim);
+    }
+    if (!aimed) return;
+
+    if (pellets > WEAPON_MAX_PELLETS) pellets = WEAPON_MAX_PELLETS;
+    if (pellets <= 1) {
+        PoolPush(&s->bullets, from.x, from.y, d.x * speed, d.y * speed, life);
+        return;
+    }
+    if (fan->pellets != pellets || fan->spreadDeg != spreadDeg) BuildFan(fan, pellets, spreadDeg);
+
+    EntityPool *p = &s->bullets;
+    int got;
+    int i = PoolPushN(p, pellets, &got), end = i + got, k = 0;
+    while (i < end) {
+        PoolChunk *ch = POOL_CHUNK(p, i);
+        int l = POOL_LANE(i);
+        int run = POOL_CHUNK_SIZE - l < end - i ? POOL_CHUNK_SIZE - l : end - i;
+        for (int j = l; j < l + run; ++j, ++k) {
+            ch->x[j] = ch->px[j] = from.x;
+            ch->y[j] = ch->py[j] = from.y;
+            ch->vx[j] = (d.x * fan->c[k] - d.y * fan->s[k]) * speed;
+            ch->vy[j] = (d.x * fan->s[k] + d.y * fan->c[k]) * speed;
+            ch->life[j] = life;
+        }
+        i += run;
+    }
+}
+
+// one fire function per SIM_WEAPONS row, that row's numbers plugged into FireFan (so
+// the pistol's is just the single-bullet path). returns the cooldown
+#define SIM_WEAPON_FIRE(id, name, rate, pellets, spread, speed, life, blast) \
+    static float Fire##id(GameState *s, Vec2 from, Vec2 aim) { \
+        const SimTuning *t = &s->tune; \
+        FireFan(s, &s->fan[SIM_WEAPON_##id], from, aim, pellets, spread, speed, life, blast); \
+        return 1.0f / (rate); \
+    }
+SIM_WEAPONS(SIM_WEAPON_FIRE)
+#undef SIM_WEAPON_FIRE
+
+static float (*const fireFns[SIM_WEAPON_COUNT])(GameState *, Vec2, Vec2) = {
+#define SIM_WEAPON_FN(id, name, rate, pellets, spread, speed, life, blast) Fire##id,
+    SIM_WEAPONS(SIM_WEAPON_FN)
+#undef SIM_WEAPON_FN
+};
+
+float SimFire(GameState *s, int k, Vec2 aim) {
+    int w = s->weapon >= 0 && s->weapon < SIM_WEAPON_COUNT ? s->weapon : SIM_WEAPON_PISTOL;
+    return fireFns[w](s, s->player[k], aim);
+}
+
+// the enemy's side of a swept query: which one, where it starts and its velocity
+typedef struct {
+    int enemy;
+    Vec2 at, vel;
+} SweptQuery;
+
+// where to look: a bullet whose step middle is further than `reach` from the middle of the
+// enemy's step can't touch it (at the moment of a hit each one is at most half its step
+// from its middle)
+static float QueryReach(float killRadius, float bulletStep, float enemyStep) {
+    return killRadius + 0.5f * (bulletStep + enemyStep) + 0.5f;    // + a half pixel for rounding in the midpoints
+}
+
+static SweptQuery QueryFor(const EntityPool *en, int ei) {
+    SweptQuery q = { ei, { POOL_GET(en, x, ei), POOL_GET(en, y, ei) }, { POOL_GET(en, vx, ei), POOL_GET(en, vy, ei) } };
+    return q;
+}
+
+// append a contact for every bullet in the grid that reaches the enemy during the step
+// (same math as KernelSwept). false if the list couldn't grow
+static bool QueryContacts(const BulletGrid *g, const SweptQuery *q, float dt, float reach, float killR2,
+                          GridContactList *out) {
+    int cx0, cy0, cx1, cy1;
+    float half = dt * 0.5f;
+    GridQueryRange(q->at.x + q->vel.x * half, q->at.y + q->vel.y * half, reach, &cx0, &cy0, &cx1, &cy1);
+    // the cells of one row sit next to each other in items, so each row is one run
+    for (int cy = cy0; cy <= cy1; ++cy) {
+        int row = cy * GRID_COLS;
+        for (int k = g->cellStart[row + cx0]; k < g->cellStart[row + cx1 + 1]; ++k) {
+            float t = g->itemT[k];
+            float dx = g->itemX[k] - q->at.x, dy = g->itemY[k] - q->at.y;
+            float wx = (g->itemVX[k] - q->vel.x) * t, wy = (g->itemVY[k] - q->vel.y) * t;
+            if (!SweptWithin(dx, dy, wx, wy, killR2)) continue;
+            GridContact hit = { SweptEntry(dx, dy, wx, wy, killR2) * t, q->enemy, g->items[k] };
+            if (!GridContactPush(out, hit)) return false;
+        }
+    }
+    return true;
+}
+
+typedef struct {
+    BulletGrid *grid;
+    const EntityPool *enemies;
+    float dt, reach, killR2;
+} ContactsJob;
+
+// one block of SIM_JOB_GRAIN enemies per index, each block has its own list
+static void ContactsJobRun(void *user, int b0, int b1) {
+    ContactsJob *j = user;
+    BulletGrid *g = j->grid;
+    for (int b = b0; b < b1; ++b) {
+        GridContactList *list = &g->blocks[b];
+        int end = (b + 1) * SIM_JOB_GRAIN < j->enemies->count ? (b + 1) * SIM_JOB_GRAIN : j->enemies->count;
+        for (int ei = b * SIM_JOB_GRAIN; ei < end && !list->failed; ++ei) {
+            SweptQuery q = QueryFor(j->enemies, ei);
+            list->failed = !QueryContacts(g, &q, j->dt, j->reach, j->killR2, list);
+        }
+    }
+}
+
+// settle order: earliest first; a tie goes to the enemy further back, then the higher
+// bullet (the old nested loop's order)
+static bool Before(const GridContact *a, const GridContact *b) {
+    if (a->t != b->t) return a->t < b->t;
+    if (a->enemy != b->enemy) return a->enemy > b->enemy;
+    return a->bullet > b->bullet;
+}
+
+static int CompareContacts(const void *a, const void *b) {
+    return Before(a, b) ? -1 : Before(b, a) ? 1 : 0;
+}
+
+// the result of taking the contacts one at a time in settle order, each bullet getting the
+// first enemy it reaches that nothing took yet, without sorting them all: every enemy
+// offers its contacts in order (deferred acceptance), a bullet keeps the earliest offer
+// and the enemy it drops moves on to its next one. with one order on both sides there's
+// exactly one outcome nobody would swap out of, the same as the one-at-a-time walk.
+// every contact is offered at most once. contacts come grouped by enemy, heldBy is
+// per-bullet scratch. both die where they met, then get swap-removed in one go
+static int ResolveContacts(GameState *s, GridContactList *l, int *heldBy) {
+    EntityPool *en = &s->enemies, *bu = &s->bullets;
+    GridContact *c = l->items;
+    int n = l->count, kills = 0;
+
+    // each enemy's contacts in order (there are one or two in normal play)
+    for (int i = 0; i < n;) {
+        int end = i + 1;
+        while (end < n && c[end].enemy == c[i].enemy) end++;
+        if (end - i > 64) {
+            qsort(c + i, (size_t)(end - i), sizeof(GridContact), CompareContacts);
+        } else {
+            for (int j = i + 1; j < end; ++j) {
+                GridContact v = c[j];
+                int k = j;
+                for (; k > i && Before(&v, &c[k - 1]); --k) c[k] = c[k - 1];
+                c[k] = v;
+            }
+        }
+        i = end;
+    }
+
+    for (int i = 0; i < n; ++i) heldBy[c[i].bullet] = -1;
+    for (int i = 0; i < n; ++i) {
+        if (i > 0 && c[i].enemy == c[i - 1].enemy) continue;    // only from each enemy's first
+        int cur = i;      // the contact on offer
+        while (cur >= 0) {
+            int *held = &heldBy[c[cur].bullet];
+            int dropped;      // whose enemy tries its next contact, -1 for nobody
+            if (*held < 0) {
+                *held = cur;
+                dropped = -1;
+            } else if (Before(&c[cur], &c[*held])) {
+                dropped = *held;
+                *held = cur;
+            } else {
+                dropped = cur;
+            }
+            cur = dropped >= 0 && dropped + 1 < n && c[dropped + 1].enemy == c[dropped].enemy ? dropped + 1 : -1;
+        }
+    }
+
+    PoolClearMarks(en);
+    PoolClearMarks(bu);
+    for (int i = 0; i < n; ++i) {
+        if (heldBy[c[i].bullet] != i) continue;
+        POOL_GET(en, mark, c[i].enemy) = 1;
+        POOL_GET(bu, mark, c[i].bullet) = 1;
+        NoteKill(s, c[i].enemy, c[i].bullet, c[i].t);
+        s->shakeTime = 0.06f; s->score += 10;
+        kills++;
+    }
+    if (kills > 0) {
+        PoolRemoveMarked(en);
+        PoolRemoveMarked(bu);
+    }
+    return kills;
+}
+
+// bullet to enemy, swept over the step both are about to take (run before either pool
+// moves). A contact is the first moment in the step where the two circles touch (only
+// up to the bullet's last moment if it expires mid-step), found from their relative
+// motion (SweptWithin / SweptEntry), so a bullet can't step over an enemy at a low tick
+// rate or on a long frame. Contacts are then settled in time order (ResolveContacts), so
+// when one bullet's step reaches two enemies the one it got to first dies, at any tick rate.
+//
+// The grid only narrows down which bullets to look at: bullets are bucketed by the
+// middle of their step and an enemy looks as far from the middle of its own step as the
+// two steps can reach. Nothing moves or dies until every contact is in, so indices stay
+// good for the whole pass.
+//
+// With job threads, the grid queries (the expensive part) run for every block of
+// enemies in parallel, each into its own list; the lists are joined in block order, so
+// the result doesn't depend on the thread count.
+int SimCollideBullets(GameState *s, float dt) {
+    EntityPool *en = &s->enemies, *bu = &s->bullets;
+    if (en->count == 0 || bu->count == 0) return 0;
+
+    const float killRadius = ENEMY_RADIUS + BULLET_RADIUS;
+    const float killR2 = killRadius * killRadius;
+    BulletGrid *g = &s->grid;
+    GridContactList *all = &g->contacts;
+    all->count = 0;
+    if (!GridReserve(g, bu->count)) return 0;   // out of memory, skip collisions this tick
+
+    // normal play has a handful of each, not worth building the grid
+    if ((long long)en->count * bu->count < GRID_MIN_PAIRS) {
+        for (int ei = 0; ei < en->count; ++ei) {
+            float ex = POOL_GET(en, x, ei), ey = POOL_GET(en, y, ei);
+            float evx = POOL_GET(en, vx, ei), evy = POOL_GET(en, vy, ei);
+            if (PoolSwept(bu, ex, ey, evx, evy, dt, killR2) == 0) continue;
+            for (int bi = 0; bi < bu->count; ++bi) {
+                if (!POOL_GET(bu, mark, bi)) continue;
+                float t = POOL_GET(bu, life, bi) < dt ? POOL_GET(bu, life, bi) : dt;
+                float dx = POOL_GET(bu, x, bi) - ex, dy = POOL_GET(bu, y, bi) - ey;
+                GridContact hit = { SweptEntry(dx, dy, (POOL_GET(bu, vx, bi) - evx) * t, (POOL_GET(bu, vy, bi) - evy) * t, killR2) * t,
+                                    ei, bi };
+                if (!GridContactPush(all, hit)) return 0;     // out of memory, skip collisions this tick
+            }
+        }
+        return ResolveContacts(s, all, g->cellOf);
+    }
+
+    GridBuild(g, bu, dt);
+    float reach = QueryReach(killRadius, PoolMaxSpeed(bu) * dt, PoolMaxSpeed(en) * dt);
+
+    bool parallel = s->jobs && en->count >= SIM_JOB_GRAIN && GridReserveBlocks(g, en->count);
+    if (parallel) {
+        ContactsJob j = { g, en, dt, reach, killR2 };
+        int blocks = (en->count + SIM_JOB_GRAIN - 1) / SIM_JOB_GRAIN;
+        JobsParallelFor(s->jobs, blocks, 1, ContactsJobRun, &j);
+        for (int b = 0; b < blocks; ++b) {
+            const GridContactList *list = &g->blocks[b];
+            if (list->failed) {
+                // a block that ran out of room gets queried again right into the full list
+                int end = (b + 1) * SIM_JOB_GRAIN < en->count ? (b + 1) * SIM_JOB_GRAIN : en->count;
+                for (int ei = b * SIM_JOB_GRAIN; ei < end; ++ei) {
+                    SweptQuery q = QueryFor(en, ei);
+                    if (!QueryContacts(g, &q, dt, reach, killR2, all)) return 0;
+                }
+                continue;
+            }
+            for (int i = 0; i < list->count; ++i) {
+                if (!GridContactPush(all, list->items[i])) return 0;
+            }
+        }
+    } else {
+        for (int ei = 0; ei < en->count; ++ei) {
+            SweptQuery q = QueryFor(en, ei);
+            if (!QueryContacts(g, &q, dt, reach, killR2, all)) return 0;
+        }
+    }
+    return ResolveContacts(s, all, g->cellOf);     // the build's scratch is free again
+}
+
+
+void SimTuningDefaults(SimTuning *t) {
+#define SIM_TUNING_DEFAULT(type, field, def) t->field = (type)(def);
+    SIM_TUNING_FIELDS(SIM_TUNING_DEFAULT)
+#undef SIM_TUNING_DEFAULT
+}
+
+bool SimTuningSet(SimTuning *t, const char *name, double value) {
+#define SIM_TUNING_SET(type, field, def) \
+    if (strcmp(name, #def) == 0) { t->field = (type)value; return true; }
+    SIM_TUNING_FIELDS(SIM_TUNING_SET)
+#undef SIM_TUNING_SET
+    return false;
+}
+
+bool SimTuningGet(const SimTuning *t, const char *name, double *value) {
+#define SIM_TUNING_GET(type, field, def) \
+    if (strcmp(name, #def) == 0) { *value = (double)t->field; return true; }
+    SIM_TUNING_FIELDS(SIM_TUNING_GET)
+#undef SIM_TUNING_GET
+    return false;
+}
+
+bool SimInit(GameState *s, int highScore, uint64_t seed) {
+    memset(s, 0, sizeof(*s));
+    SimSetPlayers(s, 1);
+    s->highScore = highScore;
+    s->seed = seed;
+    SimTuningDefaults(&s->tune);
+    if (!PoolInit(&s->enemies, ENEMY_RESERVE) || !PoolInit(&s->bullets, BULLET_RESERVE) ||
+        !ChunkListInit(&s->traces, sizeof(ShotTrace), TRACE_RESERVE, MEM_TRACES) ||
+        !GridInit(&s->grid, BULLET_RESERVE)) {
+        SimFree(s);
+        return false;
+    }
+    SimReset(s);
+    return true;
+}
+
+void SimFree(GameState *s) {
+    PoolFree(&s->enemies);
+    PoolFree(&s->bullets);
+    ChunkListFree(&s->traces);
+    GridFree(&s->grid);
+}
+
+void SimSetPlayers(GameState *s, int players) {
+    s->players = players < 1 ? 1 : players > SIM_MAX_PLAYERS ? SIM_MAX_PLAYERS : players;
+    for (int k = 0; k < SIM_MAX_PLAYERS; ++k) s->player[k] = (Vec2){ SCREEN_W * 0.5f, SCREEN_H * 0.5f };
+    if (s->players == 2) {
+        s->player[0].x -= 80.0f;
+        s->player[1].x += 80.0f;
+    }
+}
+
+// reset run (what the R key on the game over screen does)
+void SimReset(GameState *s) {
+    s->score = 0;
+    s->hp = HP_MAX;
+    s->hurtTimer = 0.0f;
+    s->shakeTime = 0.0f;
+    for (int k = 0; k < SIM_MAX_PLAYERS; ++k) s->fireCooldown[k] = 0.0f;
+    s->spawnOwed = 1.0f;          // first one right away
+    s->timeSinceStart = 0.0f;
+
+    // keeps the memory, so a restart doesn't allocate
+    PoolClear(&s->enemies);
+    PoolClear(&s->bullets);
+    ChunkListClear(&s->traces);
+    s->weapon = SIM_WEAPON_PISTOL;
+    s->justUnlockedShotgun = false;
+    s->shotgunBannerTimer = 0.0f;
+    s->newHighBanner = false;
+    s->newHighTimer = 0.0f;
+
+    s->state = STATE_PLAYING;
+}
+
+void SimRestart(GameState *s, uint64_t seed) {
+    SimReset(s);
+    s->tick = 0;
+    s->highScore = 0;
+    s->events = 0;
+    s->seed = seed;
+    s->spawnIndex = 0;            // SimReset keeps it, a run goes on through the stream
+}
+
+void SimStep(GameState *s, const SimInput *in, float dt) {
+    PROF_BEGIN(PROF_TICK);
+    s->events = 0;
+    s->tick++;
+
+    if (s->newHighTimer > 0.0f) s->newHighTimer -= dt;
+
+    if (s->state == STATE_PLAYING) {
+        // cooldown tick
+        for (int k = 0; k < s->players; ++k) {
+            if (s->fireCooldown[k] > 0.0f) s->fireCooldown[k] -= dt;
+        }
+
+        // upgrade unlock
+        if (s->weapon == SIM_WEAPON_PISTOL && s->score >= s->tune.shotgunUnlockScore) {
+            s->weapon = SIM_WEAPON_SHOTGUN;
+            s->justUnlockedShotgun = true;
+            s->shotgunBannerTimer  = 2;   // show for ~1.5 seconds
+            s->shakeTime = 0.08f; // tiny feedback bump
+            s->events |= SIM_EVENT_UNLOCK;
+            if (s->telemetry) TelemetryUnlock(s->telemetry, s->tick, SIM_WEAPON_SHOTGUN);
+        }
+
+        if (s->shotgunBannerTimer > 0.0f) s->shotgunBannerTimer -= dt;
+
+
+        for (int k = 0; k < s->players; ++k) {
+            if (!in[k].fire || s->fireCooldown[k] > 0.0f) continue;
+            // += keeps the overshoot past zero, so a held trigger fires at the real rate
+            // whatever the tick rate (the cooldown only counts down while above zero, so
+            // there's never more than a tick of it banked)
+            s->fireCooldown[k] += SimFire(s, k, in[k].aim);
+            s->shakeTime = 0.06f;
+            s->events |= SIM_EVENT_FIRED;
+        }
+
+
+        // updates
+        UpdateTraces(s, dt);
+        if (s->shakeTime > 0.0f) s->shakeTime -= dt;
+
+        s->timeSinceStart += dt;
+
+        // spawn gets faster over time (linear, clamped)
+        float currentSpawnInterval = s->tune.spawnBase - s->tune.spawnRamp * s->timeSinceStart;
+        if (currentSpawnInterval < s->tune.spawnMin) currentSpawnInterval = s->tune.spawnMin;
+        if (currentSpawnInterval < 0.0001f) currentSpawnInterval = 0.0001f;     // a sweep can set SPAWN_MIN 0
+
+        // spawn: the fraction owed carries over, so an interval shorter than a tick still
+        // gets its full rate (several per tick, as one batch)
+        PROF_BEGIN(PROF_SPAWN);
+        s->spawnOwed += dt / currentSpawnInterval;
+        if (s->spawnOwed >= 1.0f) {
+            int due = (int)s->spawnOwed;
+            s->spawnOwed -= (float)due;
+            SpawnEnemies(s, due, EnemySpeed(s));
+        }
+        PROF_END(PROF_SPAWN);
+
+        // bullet to enemy, over the step both are about to take, then the bullets move
+        PROF_BEGIN(PROF_COLLIDE_BULLETS);
+        if (SimCollideBullets(s, dt) > 0) s->events |= SIM_EVENT_KILL;
+        PROF_END(PROF_COLLIDE_BULLETS);
+
+        PROF_BEGIN(PROF_UPDATE_BULLETS);
+        UpdateBullets(s, dt);
+        PROF_END(PROF_UPDATE_BULLETS);
+
+        // enemy to player
+        if (s->hurtTimer > 0.0f) s->hurtTimer -= dt;
+
+        PROF_BEGIN(PROF_COLLIDE_PLAYER);
+        // distances in one batch; the swap-removes below only pull in enemies from
+        // further back that were already handled, so the marks stay valid
+        EntityPool *en = &s->enemies;
+        float touchRadius = ENEMY_RADIUS + PLAYER_RADIUS;
+        for (int k = 0; k < s->players; ++k) {
+            Vec2 pl = s->player[k];
+            int touching = PoolWithin(en, pl.x, pl.y, touchRadius * touchRadius);
+
+            for (int ei = en->count - 1; ei >= 0 && touching > 0; --ei) {
+                if (POOL_GET(en, mark, ei)) {
+                    touching--;
+                    bool hurt = s->hurtTimer <= 0.0f;
+                    if (hurt) {
+                        AddFx(s, SIM_FX_PLAYER_HIT, pl, pl.x - POOL_GET(en, x, ei), pl.y - POOL_GET(en, y, ei));
+                        if (s->hp > 0) s->hp -= 1;
+                        s->events |= SIM_EVENT_PLAYER_HIT;
+
+                        if (s->hp <= 0) {
+                            // GAME OVER: update high score once + show banner
+                            if (s->score > s->highScore) {
+                                s->highScore = s->score;
+                                s->newHighBanner = true;
+                                s->newHighTimer  = 2.0f;   // 2 seconds
+                                s->events |= SIM_EVENT_NEW_HIGH;
+                            }
+                            s->state = STATE_GAME_OVER;
+                            s->events |= SIM_EVENT_GAME_OVER;
+                            if (s->telemetry) TelemetryGameOver(s->telemetry, s->tick, s->score, s->timeSinceStart);
+                        }
+
+                        // feedback + i-frames
+                        s->hurtTimer = s->tune.hitIframe;
+                        s->shakeTime = 0.12f;
+                    }
+
+                    // remove this enemy either way
+                    if (s->telemetry)
+                        TelemetryHit(s->telemetry, s->tick, k, POOL_GET(en, x, ei), POOL_GET(en, y, ei), s->hp, hurt);
+                    PoolRemove(en, ei);
+                }
+            }
+        }
+        PROF_END(PROF_COLLIDE_PLAYER);
+
+        PROF_BEGIN(PROF_UPDATE_ENEMIES);
+        UpdateEnemies(s, dt);
+        PROF_END(PROF_UPDATE_ENEMIES);
+
+    // STATE_GAME_OVER
+    } else {
+        bool restart = false;
+        for (int k = 0; k < s->players; ++k) restart = restart || in[k].restart;
+        if (restart) {
+            SimReset(s);
+            s->events |= SIM_EVENT_RESTART;
+            if (s->telemetry) TelemetryRestart(s->telemetry, s->tick);
+        }
+    }
+
+    // banners are done once their timers run out (used to be cleared while drawing)
+    if (s->shotgunBannerTimer <= 0.0f) s->justUnlockedShotgun = false;
+    if (s->newHighTimer <= 0.0f) s->newHighBanner = false;
+    if (s->telemetry) TelemetryTick(s->telemetry, s->tick, s->enemies.count, s->bullets.count);
+    PROF_END(PROF_TICK);
+}
+
+
+// FNV-1a, fed field by field (no struct padding or pointers in the hash)
+static uint64_t HashBytes(uint64_t h, const void *data, size_t n) {
+    const unsigned char *p = data;
+    for (size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 0x100000001B3ull; }
+    return h;
+}
+
+#define HASH_VAL(h, v) ((h) = HashBytes((h), &(v), sizeof(v)))
+
+// same bytes in the same order as hashing whole flat arrays, just a chunk at a time
+static uint64_t HashField(uint64_t h, const EntityPool *p, size_t offset) {
+    for (int c = 0; c < POOL_USED_CHUNKS(p); ++c)
+        h = HashBytes(h, (const char *)p->chunks[c] + offset, sizeof(float) * (size_t)POOL_CHUNK_COUNT(p, c));
+    return h;
+}
+
+static uint64_t HashPool(uint64_t h, const EntityPool *p, bool withLife) {
+    HASH_VAL(h, p->count);
+    h = HashField(h, p, offsetof(PoolChunk, x));  h = HashField(h, p, offsetof(PoolChunk, y));
+    h = HashField(h, p, offsetof(PoolChunk, vx)); h = HashField(h, p, offsetof(PoolChunk, vy));
+    if (withLife) h = HashField(h, p, offsetof(PoolChunk, life));
+    return h;
+}
+
+uint64_t SimHash(const GameState *s) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    h = HashPool(h, &s->enemies, false);
+    h = HashPool(h, &s->bullets, true);
+    HASH_VAL(h, s->traces.count);
+    for (int i = 0; i < s->traces.count; ++i) {
+        const ShotTrace *t = ChunkListAt(&s->traces, i);
+        HASH_VAL(h, t->a); HASH_VAL(h, t->b); HASH_VAL(h, t->life);
+    }
+    int state = (int)s->state, flags = s->weapon | s->justUnlockedShotgun << 8 | s->newHighBanner << 9;
+    HASH_VAL(h, s->score);          HASH_VAL(h, s->highScore);
+    HASH_VAL(h, s->hp);             HASH_VAL(h, state);
+    HASH_VAL(h, flags);             HASH_VAL(h, s->tick);
+    HASH_VAL(h, s->timeSinceStart); HASH_VAL(h, s->shakeTime);
+    for (int k = 0; k < s->players; ++k) HASH_VAL(h, s->fireCooldown[k]);
+    HASH_VAL(h, s->spawnOwed);
+    HASH_VAL(h, s->spawnIndex);
+    HASH_VAL(h, s->hurtTimer);      HASH_VAL(h, s->newHighTimer);
+    HASH_VAL(h, s->shotgunBannerTimer);
+    return h;
+}
+
+void SimClockInit(SimClock *c, int hz) {
+    c->hz = hz > 0 ? hz : SIM_TICK_HZ;
+    c->step = 1.0f / (float)c->hz;
+    c->acc = 0.0f;
+    c->events = 0;
+    c->restartPending = false;
+    c->onTick = NULL;
+    c->onTickUser = NULL;
+}
+
+int SimAdvance(GameState *s, SimClock *c, const SimInput *in, float frameTime) {
+    if (frameTime > SIM_MAX_FRAME) frameTime = SIM_MAX_FRAME;   // hitch: slow down, don't explode
+    c->acc += frameTime;
+    c->events = 0;
+
+    SimInput tick = *in;
+    tick.restart = in->restart || c->restartPending;
+    int ticks = 0;
+    while (c->acc >= c->step) {
+        if (c->onTick) c->onTick(c->onTickUser, s, &tick);
+        SimStep(s, &tick, c->step);
+        c->events |= s->events;
+        c->acc -= c->step;
+        tick.restart = false;     // one press, one restart
+        ticks++;
+    }
+    c->restartPending = tick.restart;
+    return ticks;
+}
+
+int SimAdvanceEach(GameState *s, SimClock *c, SimInputFn next, void *user, float frameTime) {
+    if (frameTime > SIM_MAX_FRAME) frameTime = SIM_MAX_FRAME;
+    c->acc += frameTime;
+    c->events = 0;
+
+    int ticks = 0;
+    while (c->acc >= c->step) {
+        SimInput tick;
+        next(user, c->acc - c->step, &tick);
+        tick.restart = tick.restart || c->restartPending;
+        c->restartPending = false;
+        if (c->onTick) c->onTick(c->onTickUser, s, &tick);
+        SimStep(s, &tick, c->step);
+        c->events |= s->events;
+        c->acc -= c->step;
+        ticks++;
+    }
+    return ticks;
+}
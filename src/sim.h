@@ -0,0 +1,207 @@
+// NULL TERMINATOR — simulation core
+// All the game rules live here: firing, spawning, collisions, score, game over.
+// No raylib in here on purpose, so the same code runs in the window and headless.
+
+#ifndef NT_SIM_H
+#define NT_SIM_H
+
+#include "tuning.h"
+#include "grid.h"
+#include "pool.h"
+#include "spawn.h"
+#include <stdbool.h>
+
+// plain 2D vector, same layout as raylib's Vector2
+typedef struct {
+    float x, y;
+} Vec2;
+
+// struct to store shot effect (start point, end point and time to live)
+typedef struct {
+    Vec2  a, b;       // line from A (player) to B (impact point = cursor)
+    float life;       // remaining lifetime (seconds)
+} ShotTrace;
+
+typedef enum { STATE_PLAYING = 0, STATE_GAME_OVER = 1 } RunState;
+
+// one tick worth of player intent, filled by whoever is driving (window, bot, test)
+typedef struct {
+    Vec2 aim;        // crosshair position in screen space
+    bool fire;       // fire held (mouse left or space)
+    bool restart;    // restart requested (only used on the game over screen)
+} SimInput;
+
+// things that happened during the last SimStep, for the caller to react to
+enum {
+    SIM_EVENT_FIRED      = 1 << 0,
+    SIM_EVENT_KILL       = 1 << 1,
+    SIM_EVENT_PLAYER_HIT = 1 << 2,
+    SIM_EVENT_GAME_OVER  = 1 << 3,
+    SIM_EVENT_NEW_HIGH   = 1 << 4,   // highScore changed (the run itself is reported by GAME_OVER)
+    SIM_EVENT_UNLOCK     = 1 << 5,
+    SIM_EVENT_RESTART    = 1 << 6,
+};
+
+// runtime copy of the SIM_TUNING_FIELDS defines (tuning.h)
+typedef struct {
+#define SIM_TUNING_MEMBER(type, field, def) type field;
+    SIM_TUNING_FIELDS(SIM_TUNING_MEMBER)
+#undef SIM_TUNING_MEMBER
+} SimTuning;
+
+// SIM_WEAPONS (tuning.h) as an enum
+typedef enum {
+#define SIM_WEAPON_ENUM(id, name, rate, pellets, spread, speed, life, blast) SIM_WEAPON_##id,
+    SIM_WEAPONS(SIM_WEAPON_ENUM)
+#undef SIM_WEAPON_ENUM
+    SIM_WEAPON_COUNT
+} SimWeapon;
+
+// one weapon's pellet directions relative to straight ahead (cos, sin of each fan
+// angle). built on its first shot, again if its pellet count or spread changes
+typedef struct {
+    int pellets;
+    float spreadDeg;
+    float c[WEAPON_MAX_PELLETS], s[WEAPON_MAX_PELLETS];
+} WeaponFan;
+
+// "something happened here" for effects (particles): the sim only appends to a ring,
+// readers keep their own cursor. cosmetic, so not hashed and not in snapshots
+typedef enum {
+    SIM_FX_KILL = 0,         // enemy died at pos, dir = the bullet's heading
+    SIM_FX_PLAYER_HIT,       // pos = player, dir = away from the enemy that hit
+    SIM_FX_SHOTGUN,          // pos = muzzle, dir = aim
+} SimFxKind;
+
+typedef struct {
+    Vec2 pos, dir;           // dir is unit length (or zero)
+    int kind;
+} SimFx;
+
+struct JobSystem;
+struct Telemetry;
+
+#define SIM_MAX_PLAYERS 2
+
+typedef struct GameState {
+    // gunners, locked in place: one at the center, or two side by side in co-op
+    // (SimSetPlayers). they share hp and score, each has its own aim and cooldown
+    int players;
+    Vec2 player[SIM_MAX_PLAYERS];
+
+    EntityPool enemies;           // x, y, vx, vy (life unused)
+    EntityPool bullets;           // x, y, vx, vy, life
+
+    ChunkList traces;             // ShotTrace, .count is how many are alive
+
+    int score;
+    int highScore;
+    bool newHighBanner;
+    float newHighTimer;
+
+    float timeSinceStart;
+    float shakeTime;
+    float fireCooldown[SIM_MAX_PLAYERS];
+    float spawnOwed;              // spawns due but not made yet, the fraction carries to the next tick
+    uint64_t spawnIndex;          // enemies spawned since SimInit = position in the spawn stream
+
+    int hp;
+    float hurtTimer;
+
+    RunState state;
+
+    int weapon;                   // SimWeapon, the pistol until the shotgun unlocks
+    bool justUnlockedShotgun;
+    float shotgunBannerTimer;
+
+    unsigned events;              // SIM_EVENT_* bits from the last step
+    uint32_t tick;                // SimSteps since SimInit
+    uint64_t seed;                // keys the spawn stream, a seed + inputs replays a run
+
+    // balance numbers, the tuning.h defaults unless someone changed them after SimInit.
+    // not part of SimHash: replays assume the defaults
+    SimTuning tune;
+
+    // effect records, fx[n % SIM_FX_RING] for n < fxCount (fxCount only ever goes up)
+    SimFx fx[SIM_FX_RING];
+    uint32_t fxCount;
+
+    // collision scratch, rebuilt every tick (not really game state)
+    BulletGrid grid;
+
+    // pellet fans per weapon, a function of tune (not state)
+    WeaponFan fan[SIM_WEAPON_COUNT];
+
+    // cached block of spawn positions, a function of seed + spawnIndex (not state either)
+    SpawnStream spawnStream;
+
+    // optional worker threads for the big loops (NULL = all on the calling thread).
+    // owned by the caller; results are identical with any thread count
+    struct JobSystem *jobs;
+
+    // optional gameplay log (src/telemetry.h, NULL = off), also owned by the caller
+    struct Telemetry *telemetry;
+} GameState;
+
+void SimTuningDefaults(SimTuning *t);
+
+// get/set a knob by its define name ("SPAWN_RAMP"). false if there's no such knob
+bool SimTuningSet(SimTuning *t, const char *name, double value);
+bool SimTuningGet(const SimTuning *t, const char *name, double *value);
+
+// allocates the entity pools, false if that failed. pair with SimFree
+bool SimInit(GameState *s, int highScore, uint64_t seed);
+void SimFree(GameState *s);
+void SimReset(GameState *s);
+// a new run from seed on s's memory, as SimInit(s, 0, seed) left it (tuning, players,
+// jobs and telemetry stay as they are). for tools that play many runs on one state
+void SimRestart(GameState *s, uint64_t seed);
+// in[k] drives player k, so in points at s->players inputs (just one in solo)
+void SimStep(GameState *s, const SimInput *in, float dt);
+
+// 1 (solo, the default) or 2 (co-op). moves the gunners, call it before the first step
+void SimSetPlayers(GameState *s, int players);
+
+// n enemies right now, from the same spawn stream and at the current enemy speed, as
+// one batch (stress tests). returns how many fit
+int SimSpawnEnemies(GameState *s, int n);
+
+// one shot of player k's current weapon at aim (bullets, trace, muzzle flash), cooldown
+// or not. returns the seconds until it can fire again. SimStep calls this
+float SimFire(GameState *s, int k, Vec2 aim);
+
+// 64-bit hash of everything that decides where the run goes next (entities, timers,
+// spawn stream position, score...). two runs with the same hash at the same tick are the same game
+uint64_t SimHash(const GameState *s);
+
+// called with the exact input of every fixed tick, before it's simulated (replay recording)
+typedef void (*SimTickHook)(void *user, const GameState *s, const SimInput *in);
+
+// fixed-rate stepping: accumulator and tick length (see SimAdvance)
+typedef struct {
+    float step;                   // seconds per tick, 1/SIM_TICK_HZ by default
+    int hz;
+    float acc;                    // unsimulated time carried over to the next frame
+    unsigned events;              // SIM_EVENT_* bits OR'd over every tick of the last advance
+    bool restartPending;          // R pressed on a frame too short to run a tick
+    SimTickHook onTick;           // optional
+    void *onTickUser;
+} SimClock;
+
+void SimClockInit(SimClock *c, int hz);
+
+// run as many fixed ticks as frameTime covers (same input for each), returns the
+// tick count. afterwards c->acc / c->step is how far we are into the next tick
+int SimAdvance(GameState *s, SimClock *c, const SimInput *in, float frameTime);
+
+// same, with a fresh input per tick: next() fills the input of a tick that ends `behind`
+// seconds before the end of frameTime (the newest tick of the frame has the smallest).
+// a restart left pending by SimAdvance is OR'd into the first tick
+typedef void (*SimInputFn)(void *user, float behind, SimInput *out);
+int SimAdvanceEach(GameState *s, SimClock *c, SimInputFn next, void *user, float frameTime);
+
+// bullet vs enemy pass on its own (grid broadphase), returns kills. swept over the
+// next dt of both pools' motion, so it runs before they move. SimStep calls this.
+int SimCollideBullets(GameState *s, float dt);
+
+#endif
@@ -0,0 +1,81 @@
+// NULL TERMINATOR — state snapshots
+
+#include "snapshot.h"
+#include "mem.h"
+#include <string.h>
+
+// every GameState field that's part of the run (same set SimHash covers, plus the
+// seed and tuning). a new field in GameState that matters goes here too
+#define SNAP_SCALARS(X) \
+    X(players) X(player) X(score) X(highScore) X(newHighBanner) X(newHighTimer) \
+    X(timeSinceStart) X(shakeTime) X(fireCooldown) X(spawnOwed) X(spawnIndex) \
+    X(hp) X(hurtTimer) X(state) \
+    X(weapon) X(justUnlockedShotgun) X(shotgunBannerTimer) \
+    X(events) X(tick) X(seed) X(tune)
+
+#define SNAP_SIZE(f) + sizeof(((GameState *)0)->f)
+#define SCALAR_BYTES (0 SNAP_SCALARS(SNAP_SIZE))
+
+typedef struct {
+    char magic[4];           // "NTSS"
+    uint32_t version;
+    uint32_t scalarBytes;    // layout checks, a different build won't match
+    uint32_t traceBytes;
+    int32_t enemies, bullets, traces;
+    uint32_t pad;
+    uint64_t size;           // whole snapshot, header included
+} SnapHeader;
+
+void SnapshotFree(Snapshot *snap) {
+    MemFree(snap->data);
+    memset(snap, 0, sizeof(*snap));
+}
+
+bool SnapshotSave(Snapshot *snap, const GameState *s) {
+    size_t size = sizeof(SnapHeader) + SCALAR_BYTES + PoolFlatSize(&s->enemies) + PoolFlatSize(&s->bullets) +
+                  (size_t)s->traces.count * sizeof(ShotTrace);
+    if (size > snap->capacity) {
+        // some headroom so a slowly growing run doesn't realloc every save
+        size_t cap = size + size / 4;
+        unsigned char *data = MemRealloc(MEM_SNAPSHOT, snap->data, cap);
+        if (!data) return false;
+        snap->data = data;
+        snap->capacity = cap;
+    }
+
+    SnapHeader h = { { 'N', 'T', 'S', 'S' }, SNAPSHOT_VERSION, SCALAR_BYTES, sizeof(ShotTrace),
+                     s->enemies.count, s->bullets.count, s->traces.count, 0, size };
+    unsigned char *p = snap->data;
+    memcpy(p, &h, sizeof(h));
+    p += sizeof(h);
+#define SNAP_PUT(f) memcpy(p, &s->f, sizeof(s->f)); p += sizeof(s->f);
+    SNAP_SCALARS(SNAP_PUT)
+#undef SNAP_PUT
+    p = PoolFlatSave(&s->enemies, p);
+    p = PoolFlatSave(&s->bullets, p);
+    ChunkListFlatSave(&s->traces, p);
+    snap->size = size;
+    return true;
+}
+
+bool SnapshotRestore(const Snapshot *snap, GameState *s) {
+    SnapHeader h;
+    if (snap->size < sizeof(h)) return false;
+    memcpy(&h, snap->data, sizeof(h));
+    if (memcmp(h.magic, "NTSS", 4) != 0 || h.version != SNAPSHOT_VERSION || h.scalarBytes != SCALAR_BYTES ||
+        h.traceBytes != sizeof(ShotTrace) || h.size != snap->size || h.enemies < 0 || h.bullets < 0 || h.traces < 0 ||
+        h.size != sizeof(h) + SCALAR_BYTES + sizeof(float) * POOL_FLAT_FIELDS * ((uint64_t)h.enemies + (uint64_t)h.bullets) +
+                  sizeof(ShotTrace) * (uint64_t)h.traces) {
+        return false;
+    }
+
+    const unsigned char *p = snap->data + sizeof(h);
+#define SNAP_GET(f) memcpy(&s->f, p, sizeof(s->f)); p += sizeof(s->f);
+    SNAP_SCALARS(SNAP_GET)
+#undef SNAP_GET
+    if (!PoolFlatLoad(&s->enemies, h.enemies, p)) return false;
+    p += PoolFlatSize(&s->enemies);
+    if (!PoolFlatLoad(&s->bullets, h.bullets, p)) return false;
+    p += PoolFlatSize(&s->bullets);
+    return ChunkListFlatLoad(&s->traces, h.traces, p);
+}
@@ -0,0 +1,38 @@
+// NULL TERMINATOR — state snapshots
+// Everything that decides where a run goes next (entities, timers, spawn index, score,
+// hp, weapon, tuning) copied into one flat buffer: a fixed header, the scalar fields,
+// then each pool as plain float arrays and the traces back to back. Saving and restoring
+// are a handful of memcpys per 1024 entities, no per-entity work beyond handing out
+// fresh handles, so it's cheap enough for quick-save, rewinds and rollback.
+//
+// Restoring a snapshot and feeding the same inputs lands on the same SimHash as the
+// original run. Scratch (grid, hit lists) and the job system pointer aren't included.
+//
+// The layout is the in-memory one (native endianness, struct sizes), meant to live in
+// memory or go between identical builds; the header checks version and sizes and
+// refuses anything else.
+
+#ifndef NT_SNAPSHOT_H
+#define NT_SNAPSHOT_H
+
+#include "sim.h"
+#include <stddef.h>
+
+#define SNAPSHOT_VERSION 5
+
+typedef struct {
+    unsigned char *data;
+    size_t size;             // bytes used by the last save
+    size_t capacity;         // kept across saves, so saving the same size again doesn't allocate
+} Snapshot;
+
+void SnapshotFree(Snapshot *snap);
+
+// false only if the buffer couldn't grow
+bool SnapshotSave(Snapshot *snap, const GameState *s);
+
+// false if snap isn't a valid snapshot for this build or a pool couldn't grow (s is
+// left half-restored then, SimReset it)
+bool SnapshotRestore(const Snapshot *snap, GameState *s);
+
+#endif
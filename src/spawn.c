@@ -0,0 +1,36 @@
+// NULL TERMINATOR — spawn stream
+
+#include "spawn.h"
+#include "tuning.h"
+
+// just off one of the four edges, uniform along it (same spread as the old AddEnemy)
+static void Fill(SpawnStream *st, uint64_t seed, uint64_t block) {
+    uint64_t key = seed ^ 0x5350415741ull, n = block * SPAWN_BLOCK;
+    for (int i = 0; i < SPAWN_BLOCK; ++i, ++n) {
+        uint64_t z = key + n * 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+
+        uint32_t r = (uint32_t)z;
+        float acrossW = (float)(r % (SCREEN_W + 1)), acrossH = (float)(r % (SCREEN_H + 1));
+        switch (z >> 62) {
+            case 0:  st->x[i] = -10;            st->y[i] = acrossH;       break;
+            case 1:  st->x[i] = SCREEN_W + 10;  st->y[i] = acrossH;       break;
+            case 2:  st->x[i] = acrossW;        st->y[i] = -10;           break;
+            default: st->x[i] = acrossW;        st->y[i] = SCREEN_H + 10; break;
+        }
+    }
+    st->seed = seed;
+    st->block = block;
+    st->filled = 1;
+}
+
+int SpawnStreamAt(SpawnStream *st, uint64_t seed, uint64_t index, const float **x, const float **y) {
+    uint64_t block = index / SPAWN_BLOCK;
+    int at = (int)(index % SPAWN_BLOCK);
+    if (!st->filled || st->seed != seed || st->block != block) Fill(st, seed, block);
+    *x = st->x + at;
+    *y = st->y + at;
+    return SPAWN_BLOCK - at;
+}
@@ -0,0 +1,25 @@
+// NULL TERMINATOR — spawn stream
+// Where the n-th enemy of a run comes in is a pure function of the run's seed and n
+// (splitmix64 of the two), worked out a block at a time into a small cache. A batch of
+// spawns then just copies positions out of the block instead of making a few rng calls
+// each, and the only state the hash or a snapshot needs is n (GameState.spawnIndex).
+
+#ifndef NT_SPAWN_H
+#define NT_SPAWN_H
+
+#include <stdint.h>
+
+#define SPAWN_BLOCK 1024              // positions per cached block
+
+// zeroed is a valid empty cache
+typedef struct {
+    uint64_t seed, block;             // what x/y hold, if filled
+    int filled;
+    float x[SPAWN_BLOCK], y[SPAWN_BLOCK];
+} SpawnStream;
+
+// positions of spawns index, index+1, ... of the run seeded with seed, up to the end of
+// index's block: *x and *y point into the cache, returns how many (1..SPAWN_BLOCK)
+int SpawnStreamAt(SpawnStream *st, uint64_t seed, uint64_t index, const float **x, const float **y);
+
+#endif
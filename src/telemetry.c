@@ -0,0 +1,305 @@
+// NULL TERMINATOR — gameplay telemetry log
+
+#define _POSIX_C_SOURCE 200112L
+#include "telemetry.h"
+#include "fixed.h"
+#include "mem.h"
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+#define SWAP_EVERY 1000000000ull     // ns, hand over a part-filled buffer at least this often
+
+// fields per record kind (TelKind order)
+static const int fieldCount[TEL_KIND_COUNT] = { 2, 1, 5, 5, 1, 2, 0, 1, 1, 0 };
+
+static uint64_t NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void PutLE(unsigned char *p, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static uint64_t GetLE(const unsigned char *p, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+// zigzag varint: small magnitudes of either sign take one byte
+static unsigned char *PutVar(unsigned char *p, int32_t v) {
+    uint32_t u = ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+    while (u >= 0x80) { *p++ = (unsigned char)(u | 0x80); u >>= 7; }
+    *p++ = (unsigned char)u;
+    return p;
+}
+
+static void *FlushMain(void *arg) {
+    Telemetry *t = arg;
+    pthread_mutex_lock(&t->lock);
+    for (;;) {
+        while (!t->pending && !t->quit) pthread_cond_wait(&t->wake, &t->lock);
+        if (!t->pending) break;      // quit and nothing left
+        int idx = t->active ^ 1;
+        pthread_mutex_unlock(&t->lock);
+
+        bool ok = fwrite(t->buf[idx], 1, (size_t)t->len[idx], t->file) == (size_t)t->len[idx] && fflush(t->file) == 0;
+
+        pthread_mutex_lock(&t->lock);
+        if (!ok) t->writeFailures++;
+        t->flushes++;
+        t->pending = false;
+        pthread_cond_broadcast(&t->wake);
+    }
+    pthread_mutex_unlock(&t->lock);
+    return NULL;
+}
+
+// hand the active buffer to the thread and start on the other one. false if the thread
+// still has the other one
+static bool Swap(Telemetry *t) {
+    if (!t->running) {
+        // no thread: the rare box that can't start one writes inline
+        if (fwrite(t->buf[t->active], 1, (size_t)t->len[t->active], t->file) != (size_t)t->len[t->active]) t->writeFailures++;
+        t->flushes++;
+        t->len[t->active] = 0;
+        return true;
+    }
+    pthread_mutex_lock(&t->lock);
+    bool idle = !t->pending;
+    if (idle) {
+        t->pending = true;
+        t->active ^= 1;
+        t->len[t->active] = 0;
+        pthread_cond_broadcast(&t->wake);
+    }
+    pthread_mutex_unlock(&t->lock);
+    return idle;
+}
+
+static void WaitIdle(Telemetry *t) {
+    if (!t->running) return;
+    pthread_mutex_lock(&t->lock);
+    while (t->pending) pthread_cond_wait(&t->wake, &t->lock);
+    pthread_mutex_unlock(&t->lock);
+}
+
+// room for one record and its kind + tick byte(s), NULL (and counted) if there's none
+static unsigned char *Begin(Telemetry *t, TelKind kind, uint32_t tick) {
+    if (t->len[t->active] + TELEMETRY_RECORD_MAX > TELEMETRY_BUFFER) {
+        if (!Swap(t)) { t->dropped++; return NULL; }
+        t->lastSwap = NowNs();
+    }
+    unsigned char *p = t->buf[t->active] + t->len[t->active];
+    int32_t dt = (int32_t)(tick - t->lastTick);   // negative after a rewind (F9)
+    t->lastTick = tick;
+    if (dt >= 0 && dt < 15) {
+        *p++ = (unsigned char)(kind | dt << 4);
+    } else {
+        *p++ = (unsigned char)(kind | 15 << 4);
+        p = PutVar(p, dt);
+    }
+    return p;
+}
+
+static void End(Telemetry *t, unsigned char *p) {
+    int len = (int)(p - t->buf[t->active]);
+    t->bytes += (uint64_t)(len - t->len[t->active]);
+    t->len[t->active] = len;
+    t->records++;
+}
+
+bool TelemetryOpen(Telemetry *t, const char *path, uint64_t seed, int hz, uint32_t tick) {
+    memset(t, 0, sizeof(*t));
+    t->file = fopen(path, "wb");
+    if (!t->file) return false;
+
+    unsigned char *h = t->buf[0];
+    memcpy(h, "NTTL", 4);
+    PutLE(h + 4, TELEMETRY_VERSION, 2);
+    PutLE(h + 6, (uint64_t)hz, 2);
+    PutLE(h + 8, seed, 8);
+    PutLE(h + 16, tick, 4);
+    t->len[0] = TELEMETRY_HEADER;
+    t->bytes = TELEMETRY_HEADER;
+    t->lastTick = t->seenTick = tick;
+    t->lastSwap = NowNs();
+    MemNoteHeld(MEM_IO, sizeof(t->buf));
+
+    pthread_mutex_init(&t->lock, NULL);
+    pthread_cond_init(&t->wake, NULL);
+    t->running = pthread_create(&t->thread, NULL, FlushMain, t) == 0;
+    return true;
+}
+
+void TelemetryClose(Telemetry *t) {
+    if (!t->file) return;
+    WaitIdle(t);
+    unsigned char *p = Begin(t, TEL_END, t->seenTick);
+    if (p) End(t, p);
+
+    if (t->running) {
+        WaitIdle(t);
+        pthread_mutex_lock(&t->lock);
+        if (t->len[t->active] > 0) {
+            t->pending = true;
+            t->active ^= 1;
+            t->len[t->active] = 0;
+        }
+        t->quit = true;
+        pthread_cond_broadcast(&t->wake);
+        pthread_mutex_unlock(&t->lock);
+        pthread_join(t->thread, NULL);
+        t->running = false;
+    } else {
+        Swap(t);
+    }
+    if (fclose(t->file) != 0) t->writeFailures++;
+    t->file = NULL;
+    MemNoteHeld(MEM_IO, -(int64_t)sizeof(t->buf));
+}
+
+static int Px(float v) { return (int)lrintf(v); }
+
+void TelemetryTick(Telemetry *t, uint32_t tick, int enemies, int bullets) {
+    t->seenTick = tick;
+    if (enemies != t->lastEnemies || bullets != t->lastBullets || t->rewound) {
+        unsigned char *p = Begin(t, TEL_TICK, tick);
+        if (p) {
+            p = PutVar(p, enemies - t->lastEnemies);
+            p = PutVar(p, bullets - t->lastBullets);
+            End(t, p);
+            t->lastEnemies = enemies;
+            t->lastBullets = bullets;
+            t->rewound = false;
+        }
+    }
+    // a quiet stretch still reaches the disk within about a second (the clock is only
+    // read every 64 ticks)
+    if ((tick & 63) == 0 && t->len[t->active] > 0 && NowNs() - t->lastSwap > SWAP_EVERY && Swap(t)) t->lastSwap = NowNs();
+}
+
+void TelemetrySpawn(Telemetry *t, uint32_t tick, int count) {
+    unsigned char *p = Begin(t, TEL_SPAWN, tick);
+    if (!p) return;
+    End(t, PutVar(p, count));
+}
+
+void TelemetryKill(Telemetry *t, uint32_t tick, float ex, float ey, float bx, float by, float bvx, float bvy) {
+    unsigned char *p = Begin(t, TEL_KILL, tick);
+    if (!p) return;
+    int heading = ((FxAtan2(FxFromFloat(bvy), FxFromFloat(bvx)) + 128) >> 8) & 255;   // table, not libm
+    p = PutVar(p, Px(ex));
+    p = PutVar(p, Px(ey));
+    p = PutVar(p, Px(bx - ex));
+    p = PutVar(p, Px(by - ey));
+    End(t, PutVar(p, heading));
+}
+
+void TelemetryHit(Telemetry *t, uint32_t tick, int player, float ex, float ey, int hp, bool hurt) {
+    unsigned char *p = Begin(t, TEL_HIT, tick);
+    if (!p) return;
+    p = PutVar(p, player);
+    p = PutVar(p, Px(ex));
+    p = PutVar(p, Px(ey));
+    p = PutVar(p, hp);
+    End(t, PutVar(p, hurt ? 1 : 0));
+}
+
+void TelemetryUnlock(Telemetry *t, uint32_t tick, int weapon) {
+    unsigned char *p = Begin(t, TEL_UNLOCK, tick);
+    if (!p) return;
+    End(t, PutVar(p, weapon));
+}
+
+void TelemetryGameOver(Telemetry *t, uint32_t tick, int score, float survived) {
+    unsigned char *p = Begin(t, TEL_GAME_OVER, tick);
+    if (!p) return;
+    p = PutVar(p, score);
+    End(t, PutVar(p, (int32_t)lrintf(survived * 1000.0f)));
+}
+
+void TelemetryRestart(Telemetry *t, uint32_t tick) {
+    unsigned char *p = Begin(t, TEL_RESTART, tick);
+    if (p) End(t, p);
+}
+
+void TelemetryFrame(Telemetry *t, uint32_t tick, float frameTime) {
+    int us = (int)lrintf(frameTime * 1e6f);
+    unsigned char *p = Begin(t, TEL_FRAME, tick);
+    if (!p) return;
+    End(t, PutVar(p, us - t->lastFrameUs));
+    t->lastFrameUs = us;
+}
+
+void TelemetryRewind(Telemetry *t, uint32_t tick, int ticks) {
+    unsigned char *p = Begin(t, TEL_REWIND, tick);
+    if (!p) return;
+    End(t, PutVar(p, ticks));
+    // the counts the reader holds may be from a superseded tick, restate them
+    t->rewound = true;
+}
+
+
+bool TelReaderInit(TelReader *r, const unsigned char *data, size_t size) {
+    memset(r, 0, sizeof(*r));
+    if (size < TELEMETRY_HEADER || memcmp(data, "NTTL", 4) != 0) return false;
+    r->version = (int)GetLE(data + 4, 2);
+    if (r->version != TELEMETRY_VERSION) return false;
+    r->hz = (int)GetLE(data + 6, 2);
+    r->seed = GetLE(data + 8, 8);
+    r->tick = (uint32_t)GetLE(data + 16, 4);
+    r->data = data;
+    r->size = size;
+    r->pos = TELEMETRY_HEADER;
+    return true;
+}
+
+static bool GetVar(TelReader *r, int32_t *out) {
+    uint32_t u = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (r->pos >= r->size) return false;
+        unsigned char b = r->data[r->pos++];
+        u |= (uint32_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            *out = (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TelReaderNext(TelReader *r, TelRecord *out) {
+    if (r->pos >= r->size) return false;
+    unsigned char b = r->data[r->pos++];
+    int kind = b & 15, dt = b >> 4;
+    int32_t v[5] = {0};
+    bool ok = kind < TEL_KIND_COUNT;
+    if (ok && dt == 15) {
+        int32_t d = 0;
+        ok = GetVar(r, &d);
+        dt = d;
+    }
+    for (int i = 0; ok && i < fieldCount[kind]; ++i) ok = GetVar(r, &v[i]);
+    if (!ok) {
+        r->truncated = true;
+        r->pos = r->size;
+        return false;
+    }
+
+    r->tick += (uint32_t)dt;
+    if (kind == TEL_TICK) {
+        r->enemies += v[0];
+        r->bullets += v[1];
+        v[0] = r->enemies;
+        v[1] = r->bullets;
+    } else if (kind == TEL_FRAME) {
+        r->frameUs += v[0];
+        v[0] = r->frameUs;
+    }
+    *out = (TelRecord){ kind, r->tick, v[0], v[1], v[2], v[3], v[4] };
+    return true;
+}
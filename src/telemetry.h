@@ -0,0 +1,115 @@
+// NULL TERMINATOR — gameplay telemetry log
+// A compact binary stream of what happened in a session: spawns, kills (with the bullet
+// that did it), player hits, unlocks, game overs, entity counts per tick and frame
+// times. The sim writes records through GameState.telemetry (NULL = off, one branch per
+// site) and the front end adds frame times.
+//
+// Writing never touches the disk or the heap on the game thread: records go into one of
+// two fixed buffers inside the struct; when it fills (or about once a second) it's
+// handed to a flush thread and the game carries on in the other one. If the thread is
+// still busy with the other buffer the record is dropped and counted, the game never
+// waits.
+//
+// file: "NTTL" u16 version  u16 hz  u64 seed  u32 first tick, then records:
+//   byte   kind (low 4 bits) | tick delta from the previous record (high 4 bits,
+//          15 = a varint with the rest follows)
+//   fields zigzag varints, see TelKind. entity counts and frame times are
+//          deltas from the previous record of the same kind
+// A co-op rollback writes TEL_REWIND and then logs the re-simulated ticks again: every
+// record before it at or after its tick (frame times aside) is superseded.
+// `make telsum` builds bin/telsum, which summarizes a log.
+
+#ifndef NT_TELEMETRY_H
+#define NT_TELEMETRY_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define TELEMETRY_VERSION    2
+#define TELEMETRY_BUFFER     (256 * 1024)  // per buffer, two of them
+#define TELEMETRY_RECORD_MAX 40            // longest encoded record
+#define TELEMETRY_HEADER     20
+
+// fields a..e of a TelRecord, per kind
+typedef enum {
+    TEL_TICK = 0,            // a enemies, b bullets alive after the tick (only when either changed)
+    TEL_SPAWN,               // a enemies spawned this tick
+    TEL_KILL,                // a, b enemy x, y; c, d bullet offset from it; e bullet heading (256 = a turn)
+    TEL_HIT,                 // a player; b, c enemy x, y; d hp left; e 1 = it hurt, 0 = i-frames (just removed)
+    TEL_UNLOCK,              // a weapon (SimWeapon)
+    TEL_GAME_OVER,           // a score, b ms survived
+    TEL_RESTART,
+    TEL_FRAME,               // a frame time, us
+    TEL_REWIND,              // a ticks about to be simulated again from this one (co-op rollback)
+    TEL_END,                 // last record of a log that was closed properly
+    TEL_KIND_COUNT
+} TelKind;
+
+typedef struct Telemetry {
+    FILE *file;
+    pthread_t thread;
+    bool running;
+
+    pthread_mutex_t lock;    // guards active, pending, quit
+    pthread_cond_t wake;
+    unsigned char buf[2][TELEMETRY_BUFFER];
+    int len[2];
+    int active;              // the buffer the game appends to
+    bool pending;            // the other one is full and the thread hasn't written it yet
+    bool quit;
+
+    // encoder state, game thread only
+    uint32_t lastTick;       // of the last record
+    uint32_t seenTick;       // newest TelemetryTick, what TEL_END is stamped with
+    int lastEnemies, lastBullets, lastFrameUs;
+    bool rewound;            // the next TEL_TICK goes out even if the counts didn't change
+    uint64_t lastSwap;       // ns
+
+    uint64_t records, bytes;
+    uint32_t dropped, flushes, writeFailures;
+} Telemetry;
+
+// creates path and starts the flush thread (without one, full buffers are written
+// inline). false if the file couldn't be created
+bool TelemetryOpen(Telemetry *t, const char *path, uint64_t seed, int hz, uint32_t tick);
+
+// appends TEL_END, writes everything left and joins the thread
+void TelemetryClose(Telemetry *t);
+
+// recorders, game thread only
+void TelemetryTick(Telemetry *t, uint32_t tick, int enemies, int bullets);
+void TelemetrySpawn(Telemetry *t, uint32_t tick, int count);
+void TelemetryKill(Telemetry *t, uint32_t tick, float ex, float ey, float bx, float by, float bvx, float bvy);
+void TelemetryHit(Telemetry *t, uint32_t tick, int player, float ex, float ey, int hp, bool hurt);
+void TelemetryUnlock(Telemetry *t, uint32_t tick, int weapon);
+void TelemetryGameOver(Telemetry *t, uint32_t tick, int score, float survived);
+void TelemetryRestart(Telemetry *t, uint32_t tick);
+void TelemetryFrame(Telemetry *t, uint32_t tick, float frameTime);
+void TelemetryRewind(Telemetry *t, uint32_t tick, int ticks);
+
+// reading a log back (bin/telsum, the bench)
+typedef struct {
+    int kind;
+    uint32_t tick;
+    int a, b, c, d, e;
+} TelRecord;
+
+typedef struct {
+    const unsigned char *data;
+    size_t size, pos;
+    int version, hz;
+    uint64_t seed;
+    uint32_t tick;
+    int enemies, bullets, frameUs;
+    bool truncated;          // stopped at a record cut off mid-way (log not closed properly)
+} TelReader;
+
+// false if data doesn't start with a telemetry header this build reads
+bool TelReaderInit(TelReader *r, const unsigned char *data, size_t size);
+
+// next record, false at the end (or on a broken one: truncated is set)
+bool TelReaderNext(TelReader *r, TelRecord *out);
+
+#endif
@@ -0,0 +1,102 @@
+// NULL TERMINATOR — tuning
+// Every gameplay number in one place. Shared by the sim and the window build.
+
+#ifndef NT_TUNING_H
+#define NT_TUNING_H
+
+// screen
+#define SCREEN_W 960
+#define SCREEN_H 540
+
+// the sim always steps at this rate, whatever the display does (render interpolates)
+#ifndef SIM_TICK_HZ
+#define SIM_TICK_HZ 120
+#endif
+#define SIM_MAX_FRAME 0.25f   // longest frame we try to catch up on, past that the game just slows down
+
+// starter pistol
+#define FIRE_RATE 6.0f
+#define TRACE_LIFE 0.12f
+
+// starter pistol bullets
+#define BULLET_SPEED 540.0f // pixels per second
+#define BULLET_LIFETIME 0.6f // bullet on screen time
+#define BULLET_RADIUS 3.0f // how big it is
+#define BULLET_RESERVE 256   // pools grow past these, this is just what's allocated up front
+
+// #define ENEMY_SPEED 85.0f // pixels/sec
+#define ENEMY_RADIUS 8.0f
+#define ENEMY_RESERVE 256
+#define ENEMY_SPAWN_INTERVAL 1.0f // spawn one per sec (fix later)
+
+#define TRACE_RESERVE 128
+#define SIM_FX_RING 1024      // effect records kept for the renderer (power of two), older ones get overwritten
+
+#define SIM_JOB_GRAIN 1024   // entities per job when a loop is split across threads
+
+#define PLAYER_RADIUS 10.0f   // was hardcoded in draw; now a constant
+#define HP_MAX 6              // 3 hearts × 2 hits each
+#define HEARTS 3
+#define HIT_IFRAME 0.8f       // seconds of invulnerability after a hit
+
+// dificulty ramp (time based)
+#define SPAWN_BASE 1.00f // seconds between spawns at t=0
+#define SPAWN_MIN 0.20f // fastest allowed (for now heeheehee)
+#define SPAWN_RAMP 0.015f // how much to subract per second on linear approach
+
+// difficulty ramper
+#define ENEMY_SPEED_BASE 85.0f // starting speed, was ENEMY_SPEED
+#define ENEMY_SPEED_MAX 220.f // limit, no cap aye
+#define ENEMY_SPEED_RAMP 0.60f // +speed per second, 36 per minute bruh
+
+// shotgun stats
+#define SHOTGUN_UNLOCK_AFTER_SCORE 500
+#define SHOTGUN_PELLETS 5
+#define SHOTGUN_SPREAD_DEG 18.0f // around 18 degreees spread each slide
+#define SHOTGUN_FIRE_RATE 2.8f
+
+// flak: a wide burst of short-lived pellets. never unlocked in a normal run, it's the
+// heavy case for stress runs (bench weapons / flak_spam)
+#define FLAK_PELLETS 64
+#define FLAK_SPREAD_DEG 40.0f
+#define FLAK_FIRE_RATE 12.0f
+#define FLAK_SPEED 480.0f
+#define FLAK_LIFETIME 0.35f
+
+#define WEAPON_MAX_PELLETS 64   // most bullets one shot fans out into
+
+// the guns, in SimWeapon order. X(ID, name, fire rate, pellets, spread deg each side,
+// bullet speed, bullet lifetime, blast). the columns are expressions over `t`, the
+// run's SimTuning, so the knobs below still apply. blast = muzzle flash and a short
+// center trace, otherwise a trace out to the aim point
+#define SIM_WEAPONS(X) \
+    X(PISTOL,  "pistol",  t->fireRate,        1,                 0.0f,                t->bulletSpeed, t->bulletLifetime, false) \
+    X(SHOTGUN, "shotgun", t->shotgunFireRate, t->shotgunPellets, t->shotgunSpreadDeg, t->bulletSpeed, t->bulletLifetime, true) \
+    X(FLAK,    "flak",    t->flakFireRate,    t->flakPellets,    t->flakSpreadDeg,    FLAK_SPEED,     FLAK_LIFETIME,     true)
+
+#define SIM_PI 3.14159265358979323846f
+
+// the balance knobs above that can also change at runtime (GameState.tune, see
+// SimTuningSet), so bin/sweep can try other values without a rebuild.
+// X(type, field, DEFINE); everything else stays compile-time (sizes feed the grid,
+// atlas and HUD layout)
+#define SIM_TUNING_FIELDS(X) \
+    X(float, fireRate,          FIRE_RATE) \
+    X(float, bulletSpeed,       BULLET_SPEED) \
+    X(float, bulletLifetime,    BULLET_LIFETIME) \
+    X(float, hitIframe,         HIT_IFRAME) \
+    X(float, spawnBase,         SPAWN_BASE) \
+    X(float, spawnMin,          SPAWN_MIN) \
+    X(float, spawnRamp,         SPAWN_RAMP) \
+    X(float, enemySpeedBase,    ENEMY_SPEED_BASE) \
+    X(float, enemySpeedMax,     ENEMY_SPEED_MAX) \
+    X(float, enemySpeedRamp,    ENEMY_SPEED_RAMP) \
+    X(int,   shotgunUnlockScore, SHOTGUN_UNLOCK_AFTER_SCORE) \
+    X(int,   shotgunPellets,    SHOTGUN_PELLETS) \
+    X(float, shotgunSpreadDeg,  SHOTGUN_SPREAD_DEG) \
+    X(float, shotgunFireRate,   SHOTGUN_FIRE_RATE) \
+    X(int,   flakPellets,       FLAK_PELLETS) \
+    X(float, flakSpreadDeg,     FLAK_SPREAD_DEG) \
+    X(float, flakFireRate,      FLAK_FIRE_RATE)
+
+#endif
@@ -0,0 +1,1298 @@
+// NULL TERMINATOR — benchmarks
+// No window. Pools grow on their own, so any entity count works.
+//
+// usage: bin/bench [--csv out.csv] [--tag name] [benchmark...]   (default: all of them)
+//
+// micro benchmarks:
+//   collide: every-pair bullet-vs-enemy loop vs the grid broadphase, same input,
+//            checked to give the exact same result.
+//   update:  SoA integrate + cull kernels (PoolUpdate) per entity.
+//   render:  RenderBuild (interpolate + cull into draw lists), checked against a
+//            plain count of what's on screen and the expected number of batches.
+//   threads: one whole SimStep at 100k/200k entities with 1, 2, 4... job threads,
+//            checked to land on the same state hash as the single-threaded run.
+//   scores:  what a game over costs the frame (ScoreWriterSubmit) next to a blocking
+//            save and a load; the file the I/O thread wrote has to match the same
+//            runs inserted by hand.
+//   snapshot: SnapshotSave / SnapshotRestore at 1k..200k entities next to the old
+//            push-every-entity copy; the restored state has to hash the same as the
+//            original, before and after one more SimStep.
+//   particles: ParticlesUpdate + RenderAddParticles per 60 Hz frame with bursts keeping
+//            10k / 100k particles alive, as a share of a 16.7 ms frame; checked to
+//            hold the count and not allocate.
+//   fixed:   the FIXED=1 math (src/fixed.h) next to libm: ns per call and worst error,
+//            plus a checksum over every angle that has to match the one baked in here,
+//            so a compiler or machine that rounds differently shows up.
+//   input:   the input thread's SPSC ring (src/input.c): push + pop on one thread, and
+//            millions of samples through a producer thread, checked to arrive in order
+//            with nothing lost.
+//   rollback: co-op rollback (src/net.c) at late-game entity counts: what a forward
+//            tick costs with its snapshot next to a bare SimStep, and a 1 / 8 / 32 tick
+//            rollback (restore + re-simulate) as ms and as ticks re-simulated per
+//            16.7 ms frame. checked to land on the same hash as a run that had every
+//            input on time.
+//   telemetry: the late_game and swarm_10k runs with and without the gameplay log
+//            (src/telemetry.h) as ns/tick, then a flood of kill records straight at the
+//            writer; the log has to read back with every record and spawn in it, nothing
+//            dropped, and the runs have to hash the same either way.
+//   tickrate: the same bullets fired into the same enemies stepped at 240..20 Hz (swept
+//            collision, src/sim.c): kills and which enemies died have to match 240 Hz
+//            within 2% / 5%, then what a sim-second of late_game costs at each rate.
+//   weapons: SimFire per shot for every weapon in SIM_WEAPONS (fan tables) next to the
+//            old atan2 + cos/sin per pellet; checked to aim every pellet the same way
+//            and not allocate.
+//   memory:  late_game, shotgun_spam, flak_spam and swarm_10k with the render list and
+//            particles built every tick: bytes now / peak and allocations per subsystem
+//            (src/mem.h), warm-up half and steady half; the steady half has to have none.
+//
+// scenarios (whole SimSteps, scripted, same every run):
+//   late_game     ten minutes in: max enemy speed, min spawn interval, shotgun, firing
+//   shotgun_spam  a shotgun blast (SimFire) every single tick
+//   flak_spam     a 64-pellet flak burst every single tick
+//   swarm_10k     10k enemies closing in from all sides
+//   swarm_100k    same with 100k
+//   spawn_storm   a new enemy every tick for a long run
+//   spawn_flood   1000 new enemies every tick (SimSpawnEnemies), 120k by the end
+// each reports ns/tick, ns/entity, allocations during the timed ticks and peak sim heap.
+// --csv appends one row per scenario (tag = e.g. the commit) for comparing runs.
+
+#define _POSIX_C_SOURCE 200112L
+#include "sim.h"
+#include "jobs.h"
+#include "mem.h"
+#include "kernels.h"
+#include "render.h"
+#include "scores.h"
+#include "snapshot.h"
+#include "particles.h"
+#include "fixed.h"
+#include "input.h"
+#include "net.h"
+#include "telemetry.h"
+#include <limits.h>
+#include <sched.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+static double NowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static unsigned benchSeed = 1234;
+static float RandF(float lo, float hi) {
+    benchSeed = benchSeed * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(benchSeed >> 8) / 16777216.0f;
+}
+
+// every pair against every pair, kept here as the reference: the same swept contacts,
+// settled the same way (earliest first, ties to the enemy further back, then the higher
+// bullet) without the grid, the kernels or any sharing with the sim's code
+typedef struct { float t; int enemy, bullet; } NaiveContact;
+
+static int CompareNaive(const void *pa, const void *pb) {
+    const NaiveContact *a = pa, *b = pb;
+    if (a->t != b->t) return a->t < b->t ? -1 : 1;
+    if (a->enemy != b->enemy) return a->enemy > b->enemy ? -1 : 1;
+    return (a->bullet < b->bullet) - (a->bullet > b->bullet);
+}
+
+static int CollideNaive(GameState *s, float dt) {
+    EntityPool *en = &s->enemies, *bu = &s->bullets;
+    static NaiveContact *list;
+    static int cap;
+    int count = 0;
+    float r2 = (ENEMY_RADIUS + BULLET_RADIUS) * (ENEMY_RADIUS + BULLET_RADIUS);
+
+    // nothing further apart than the radius plus both fastest steps can touch
+    float fastest[2] = { 0.0f, 0.0f };
+    EntityPool *pools[2] = { en, bu };
+    for (int p = 0; p < 2; ++p) {
+        for (int i = 0; i < pools[p]->count; ++i) {
+            float vx = POOL_GET(pools[p], vx, i), vy = POOL_GET(pools[p], vy, i);
+            if (vx*vx + vy*vy > fastest[p]) fastest[p] = vx*vx + vy*vy;
+        }
+    }
+    float far = ENEMY_RADIUS + BULLET_RADIUS + (sqrtf(fastest[0]) + sqrtf(fastest[1])) * dt + 1.0f;
+    far *= far;
+
+    for (int ei = 0; ei < en->count; ++ei) {
+        float ex = POOL_GET(en, x, ei), ey = POOL_GET(en, y, ei);
+        float evx = POOL_GET(en, vx, ei), evy = POOL_GET(en, vy, ei);
+        for (int c = 0; c < POOL_USED_CHUNKS(bu); ++c) {
+            const PoolChunk *ch = bu->chunks[c];
+            for (int l = 0; l < POOL_CHUNK_COUNT(bu, c); ++l) {
+                float t = ch->life[l] < dt ? ch->life[l] : dt;
+                float dx = ch->x[l] - ex, dy = ch->y[l] - ey;
+                if (dx*dx + dy*dy > far) continue;
+                float wx = (ch->vx[l] - evx) * t, wy = (ch->vy[l] - evy) * t;
+                if (!SweptWithin(dx, dy, wx, wy, r2)) continue;
+                if (count == cap) {
+                    cap = cap ? cap * 2 : 4096;
+                    list = realloc(list, sizeof(*list) * (size_t)cap);
+                }
+                list[count++] = (NaiveContact){ SweptEntry(dx, dy, wx, wy, r2) * t, ei, (c << POOL_CHUNK_SHIFT) + l };
+            }
+        }
+    }
+    qsort(list, (size_t)count, sizeof(*list), CompareNaive);
+
+    int kills = 0;
+    PoolClearMarks(en);
+    PoolClearMarks(bu);
+    for (int i = 0; i < count; ++i) {
+        unsigned char *em = &POOL_GET(en, mark, list[i].enemy), *bm = &POOL_GET(bu, mark, list[i].bullet);
+        if (*em || *bm) continue;
+        *em = *bm = 1;
+        s->shakeTime = 0.06f; s->score += 10;
+        kills++;
+    }
+    PoolRemoveMarked(en);
+    PoolRemoveMarked(bu);
+    return kills;
+}
+
+// half enemies, half bullets, scattered over the playfield
+static void FillScatter(GameState *s, int entities) {
+    s->score = 0;
+    PoolClear(&s->enemies);
+    PoolClear(&s->bullets);
+    for (int i = 0; i < entities / 2; ++i)
+        PoolPush(&s->enemies, RandF(-10, SCREEN_W + 10), RandF(-10, SCREEN_H + 10),
+                 RandF(-200, 200), RandF(-200, 200), 0.0f);
+    for (int i = entities / 2; i < entities; ++i)
+        PoolPush(&s->bullets, RandF(-20, SCREEN_W + 20), RandF(-20, SCREEN_H + 20),
+                 RandF(-540, 540), RandF(-540, 540), RandF(0.0f, BULLET_LIFETIME));
+}
+
+// refill dst with src's entities (handles aren't copied, nothing here uses them)
+static void CopyPool(EntityPool *dst, const EntityPool *src) {
+    PoolClear(dst);
+    for (int i = 0; i < src->count; ++i)
+        PoolPush(dst, POOL_GET(src, x, i), POOL_GET(src, y, i),
+                 POOL_GET(src, vx, i), POOL_GET(src, vy, i), POOL_GET(src, life, i));
+}
+
+static void CopyEntities(GameState *dst, const GameState *src) {
+    CopyPool(&dst->enemies, &src->enemies);
+    CopyPool(&dst->bullets, &src->bullets);
+    dst->score = src->score;
+}
+
+static int SamePool(const EntityPool *a, const EntityPool *b) {
+    if (a->count != b->count) return 0;
+    for (int c = 0; c < POOL_USED_CHUNKS(a); ++c) {
+        const PoolChunk *ca = a->chunks[c], *cb = b->chunks[c];
+        size_t n = sizeof(float) * (size_t)POOL_CHUNK_COUNT(a, c);
+        if (memcmp(ca->x, cb->x, n) || memcmp(ca->y, cb->y, n) ||
+            memcmp(ca->vx, cb->vx, n) || memcmp(ca->vy, cb->vy, n) ||
+            memcmp(ca->life, cb->life, n)) return 0;
+    }
+    return 1;
+}
+
+static int SameOutcome(const GameState *a, const GameState *b) {
+    return a->score == b->score && SamePool(&a->enemies, &b->enemies) && SamePool(&a->bullets, &b->bullets);
+}
+
+// runs one pass on a fresh copy of src each rep, returns best seconds
+static double TimeCollide(int (*pass)(GameState *, float), const GameState *src, GameState *work, int reps, int *kills) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        CopyEntities(work, src);
+        double t0 = NowSeconds();
+        *kills = pass(work, 1.0f / SIM_TICK_HZ);
+        double t = NowSeconds() - t0;
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+static int BenchCollide(void) {
+    const int sizes[] = { 1000, 10000, 100000 };
+    static GameState src, naive, grid;
+    if (!SimInit(&src, 0, 0) || !SimInit(&naive, 0, 0) || !SimInit(&grid, 0, 0)) {
+        fprintf(stderr, "bench: out of memory\n");
+        return 1;
+    }
+
+    int ok = 1;
+    printf("%-10s %10s %8s %14s %14s %8s\n", "scenario", "entities", "kills", "naive_ns", "grid_ns", "speedup");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        int n = sizes[i];
+        FillScatter(&src, n);
+
+        int reps = n >= 100000 ? 3 : 20;
+        int kn, kg;
+        double tn = TimeCollide(CollideNaive, &src, &naive, n >= 100000 ? 1 : reps, &kn);
+        double tg = TimeCollide(SimCollideBullets, &src, &grid, reps, &kg);
+        if (!SameOutcome(&naive, &grid)) {
+            fprintf(stderr, "bench: grid and naive disagree at %d entities\n", n);
+            ok = 0;
+        }
+        printf("%-10s %10d %8d %14.0f %14.0f %7.1fx\n", "collide", n, kg, tn * 1e9, tg * 1e9, tn / tg);
+    }
+
+    SimFree(&src); SimFree(&naive); SimFree(&grid);
+    return ok ? 0 : 1;
+}
+
+// integrate + age + cull over both pools, one tick at 1/60
+static int BenchUpdate(void) {
+    const int sizes[] = { 1000, 10000, 100000, 200000 };
+    static GameState src, work;
+    if (!SimInit(&src, 0, 0) || !SimInit(&work, 0, 0)) {
+        fprintf(stderr, "bench: out of memory\n");
+        return 1;
+    }
+
+    printf("%-10s %10s %8s %14s %14s\n", "scenario", "entities", "culled", "tick_ns", "ns/entity");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        int n = sizes[i];
+        FillScatter(&src, n);
+        double best = 1e30;
+        int culled = 0;
+        for (int r = 0; r < 20; ++r) {
+            CopyEntities(&work, &src);
+            double t0 = NowSeconds();
+            culled  = PoolUpdate(&work.bullets, 1.0f / 60.0f, true, -20, -20, SCREEN_W + 20, SCREEN_H + 20);
+            culled += PoolUpdate(&work.enemies, 1.0f / 60.0f, false, -50, -50, SCREEN_W + 50, SCREEN_H + 50);
+            double t = NowSeconds() - t0;
+            if (t < best) best = t;
+        }
+        printf("%-10s %10d %8d %14.0f %14.2f\n", "update", n, culled, best * 1e9, best * 1e9 / n);
+    }
+
+    SimFree(&src); SimFree(&work);
+    return 0;
+}
+
+// what RenderBuild should keep: circles whose box touches the screen
+static int CountVisible(const EntityPool *p, float radius, Vec2 cam) {
+    int n = 0;
+    for (int i = 0; i < p->count; ++i) {
+        float x = POOL_GET(p, x, i) + cam.x, y = POOL_GET(p, y, i) + cam.y;
+        if (x + radius >= 0 && y + radius >= 0 && x - radius <= SCREEN_W && y - radius <= SCREEN_H) n++;
+    }
+    return n;
+}
+
+static int BenchRender(void) {
+    const int sizes[] = { 1000, 10000, 100000 };
+    static GameState src;
+    RenderList r;
+    RenderInit(&r);
+    if (!SimInit(&src, 0, 0)) {
+        fprintf(stderr, "bench: out of memory\n");
+        return 1;
+    }
+
+    int ok = 1;
+    Vec2 cam = { 4.0f, -4.0f };    // a shake offset, so the cull has to account for it
+    printf("%-10s %10s %10s %8s %6s %14s %14s\n", "scenario", "entities", "commands", "culled", "draws", "build_ns", "ns/entity");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        int n = sizes[i];
+        FillScatter(&src, n);   // fresh pushes, so prev == current and lerp doesn't matter
+
+        double best = 1e30;
+        for (int rep = 0; rep < 20; ++rep) {
+            double t0 = NowSeconds();
+            RenderBuild(&r, &src, 0.5f, cam);
+            double t = NowSeconds() - t0;
+            if (t < best) best = t;
+        }
+
+        int wantBullets = CountVisible(&src.bullets, BULLET_RADIUS, cam);
+        int wantEnemies = CountVisible(&src.enemies, ENEMY_RADIUS, cam);
+        int wantDraws = (wantBullets + RENDER_BATCH_QUADS - 1) / RENDER_BATCH_QUADS +
+                        (wantEnemies + RENDER_BATCH_QUADS - 1) / RENDER_BATCH_QUADS;
+        if (r.groups[RGROUP_BULLETS].count != wantBullets || r.groups[RGROUP_ENEMIES].count != wantEnemies ||
+            RenderCommandCount(&r) + r.culled != n || RenderDrawCalls(&r) != wantDraws) {
+            fprintf(stderr, "bench: render list doesn't match what's on screen at %d entities\n", n);
+            ok = 0;
+        }
+        printf("%-10s %10d %10d %8d %6d %14.0f %14.2f\n", "render", n, RenderCommandCount(&r), r.culled,
+               RenderDrawCalls(&r), best * 1e9, best * 1e9 / n);
+    }
+
+    RenderFree(&r);
+    SimFree(&src);
+    return ok ? 0 : 1;
+}
+
+// fresh run holding src's entities, so every rep and thread count starts from the same state
+static void ResetWork(GameState *work, const GameState *src) {
+    SimRestart(work, 0);
+    CopyEntities(work, src);
+}
+
+static int BenchThreads(void) {
+    const int sizes[] = { 100000, 200000 };
+    int maxThreads = JobsCpuCount() > 4 ? JobsCpuCount() : 4;   // always check 2 and 4 for determinism
+    static GameState src, work;
+    if (!SimInit(&src, 0, 0) || !SimInit(&work, 0, 0)) {
+        fprintf(stderr, "bench: out of memory\n");
+        return 1;
+    }
+
+    int ok = 1;
+    SimInput in = { .aim = { 0.0f, 0.0f } };
+    printf("%-10s %10s %8s %14s %14s %8s   (%d cores)\n", "scenario", "entities", "threads", "tick_ns", "ns/entity", "speedup",
+           JobsCpuCount());
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        int n = sizes[i];
+        FillScatter(&src, n);
+        double base = 0.0;
+        uint64_t baseHash = 0;
+        for (int t = 1; t <= maxThreads; t *= 2) {
+            static JobSystem jobs;
+            if (t > 1 && !JobsInit(&jobs, t)) {
+                fprintf(stderr, "bench: can't start %d threads\n", t);
+                return 1;
+            }
+            work.jobs = t > 1 ? &jobs : NULL;
+
+            double best = 1e30;
+            for (int r = 0; r < 10; ++r) {
+                ResetWork(&work, &src);
+                double t0 = NowSeconds();
+                SimStep(&work, &in, 1.0f / SIM_TICK_HZ);
+                double dt = NowSeconds() - t0;
+                if (dt < best) best = dt;
+            }
+            uint64_t h = SimHash(&work);
+            if (t == 1) { base = best; baseHash = h; }
+            else if (h != baseHash) {
+                fprintf(stderr, "bench: %d threads ended on a different state at %d entities\n", t, n);
+                ok = 0;
+            }
+            printf("%-10s %10d %8d %14.0f %14.2f %7.1fx\n", "threads", n, t, best * 1e9, best * 1e9 / n, base / best);
+
+            if (t > 1) JobsShutdown(&jobs);
+            work.jobs = NULL;
+        }
+    }
+
+    SimFree(&src); SimFree(&work);
+    return ok ? 0 : 1;
+}
+
+static bool SameBoard(const Leaderboard *a, const Leaderboard *b) {
+    if (a->count != b->count) return false;
+    for (int i = 0; i < a->count; ++i) {
+        const ScoreEntry *x = &a->entries[i], *y = &b->entries[i];
+        if (x->score != y->score || x->duration != y->duration || x->timestamp != y->timestamp) return false;
+    }
+    return true;
+}
+
+static int BenchScores(void) {
+    const char *path = "bench_scores.dat";
+    const int rounds = 20, burst = SCORES_QUEUE / 2;
+    Leaderboard want = {0}, got;
+    double submitSum = 0.0, submitMax = 0.0, saveBest = 1e30, loadBest = 1e30;
+    int ok = 1;
+
+    remove(path);
+    for (int r = 0; r < rounds; ++r) {
+        ScoreWriter w;
+        ScoreWriterStart(&w, path, &want);
+        for (int i = 0; i < burst; ++i) {
+            ScoreEntry e = { (int32_t)RandF(0, 5000), RandF(5, 600), 1700000000 + r * burst + i };
+            LeaderboardInsert(&want, e);
+            double t0 = NowSeconds();
+            ScoreWriterSubmit(&w, e);
+            double t = NowSeconds() - t0;
+            submitSum += t;
+            if (t > submitMax) submitMax = t;
+        }
+        ScoreWriterStop(&w);
+        if (w.dropped || w.failures) {
+            fprintf(stderr, "bench: score writer dropped %d / failed %d\n", w.dropped, w.failures);
+            ok = 0;
+        }
+
+        double t0 = NowSeconds();
+        bool loaded = LeaderboardLoad(&got, path);
+        double t = NowSeconds() - t0;
+        if (t < loadBest) loadBest = t;
+        if (!loaded || !SameBoard(&got, &want)) {
+            fprintf(stderr, "bench: leaderboard on disk doesn't match after round %d\n", r);
+            ok = 0;
+        }
+
+        t0 = NowSeconds();
+        LeaderboardSave(&want, path);
+        t = NowSeconds() - t0;
+        if (t < saveBest) saveBest = t;
+    }
+    remove(path);
+
+    printf("%-10s %14s %14s %14s %14s\n", "scenario", "submit_ns", "submit_max_ns", "save_us", "load_us");
+    printf("%-10s %14.0f %14.0f %14.1f %14.1f\n", "scores", submitSum / (rounds * burst) * 1e9, submitMax * 1e9,
+           saveBest * 1e6, loadBest * 1e6);
+    return ok ? 0 : 1;
+}
+
+static int BenchSnapshot(void) {
+    const int sizes[] = { 1000, 10000, 100000, 200000 };
+    static GameState src, work;
+    Snapshot snap = {0};
+    if (!SimInit(&src, 0, 7) || !SimInit(&work, 0, 8)) {
+        fprintf(stderr, "bench: out of memory\n");
+        return 1;
+    }
+
+    int ok = 1;
+    SimInput in = { .aim = { 100.0f, 100.0f }, .fire = true };
+    printf("%-10s %10s %12s %12s %12s %12s %10s\n", "scenario", "entities", "bytes", "save_ns", "restore_ns", "copy_ns", "save_GB/s");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        int n = sizes[i];
+        SimStep(&src, &in, 1.0f / SIM_TICK_HZ);    // a trace and timers in there too
+        FillScatter(&src, n);
+        FillScatter(&work, n / 3);                  // something different to restore over
+
+        double save = 1e30, restore = 1e30, copy = 1e30;
+        for (int r = 0; r < 10; ++r) {
+            double t0 = NowSeconds();
+            if (!SnapshotSave(&snap, &src)) { fprintf(stderr, "bench: snapshot out of memory\n"); return 1; }
+            double t1 = NowSeconds();
+            if (!SnapshotRestore(&snap, &work)) { fprintf(stderr, "bench: snapshot didn't restore\n"); ok = 0; }
+            double t2 = NowSeconds();
+            CopyEntities(&work, &src);
+            double t3 = NowSeconds();
+            if (t1 - t0 < save) save = t1 - t0;
+            if (t2 - t1 < restore) restore = t2 - t1;
+            if (t3 - t2 < copy) copy = t3 - t2;
+        }
+
+        SnapshotRestore(&snap, &work);
+        bool same = SimHash(&work) == SimHash(&src);
+        SimStep(&src, &in, 1.0f / SIM_TICK_HZ);
+        SimStep(&work, &in, 1.0f / SIM_TICK_HZ);
+        if (!same || SimHash(&work) != SimHash(&src)) {
+            fprintf(stderr, "bench: restored state differs from the original at %d entities\n", n);
+            ok = 0;
+        }
+        printf("%-10s %10d %12zu %12.0f %12.0f %12.0f %10.2f\n", "snapshot", n, snap.size, save * 1e9, restore * 1e9,
+               copy * 1e9, snap.size / save * 1e-9);
+    }
+
+    SnapshotFree(&snap);
+    SimFree(&src); SimFree(&work);
+    return ok ? 0 : 1;
+}
+
+static int BenchParticles(void) {
+    const int targets[] = { 10000, 100000 };
+    const float dt = 1.0f / 60.0f, avgLife = 0.4f;    // the kill burst's life range is 0.25..0.55
+    const int warm = 120, frames = 300;
+    ParticleSystem ps;
+    RenderList r;
+    RenderInit(&r);
+    if (!ParticlesInit(&ps, 1)) {
+        fprintf(stderr, "bench: out of memory\n");
+        return 1;
+    }
+
+    int ok = 1;
+    printf("%-10s %10s %10s %12s %10s %12s %6s %8s %8s\n", "scenario", "target", "alive", "update_ns", "ns/part",
+           "build_ns", "draws", "frame%", "allocs");
+    for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); ++t) {
+        int target = targets[t];
+        float perFrame = target * dt / avgLife;     // births per frame that hold the target
+        float owed = 0.0f;
+        double update = 0.0, build = 0.0;
+        long long live = 0;
+        MemStats before = {0};
+        ParticlesClear(&ps);
+
+        for (int f = 0; f < warm + frames; ++f) {
+            if (f == warm) before = MemGetStats();
+            for (owed += perFrame; owed >= 24.0f; owed -= 24.0f) {
+                Vec2 at = { RandF(0, SCREEN_W), RandF(0, SCREEN_H) }, dir = { RandF(-1, 1), RandF(-1, 1) };
+                ParticlesBurst(&ps, at, dir, 1.2f, 24, 40.0f, 260.0f, 0.25f, 0.55f, 3.0f);
+            }
+            double t0 = NowSeconds();
+            ParticlesUpdate(&ps, dt);
+            double t1 = NowSeconds();
+            RenderAddParticles(&r, &ps, (Vec2){ 0.0f, 0.0f });
+            double t2 = NowSeconds();
+            if (f >= warm) {
+                update += t1 - t0;
+                build += t2 - t1;
+                for (uint32_t n = ps.tail; n != ps.head; ++n) live += ps.life[n & (PARTICLE_CAP - 1)] > 0.0f;
+            }
+        }
+
+        long allocs = (long)(MemGetStats().allocs - before.allocs);
+        double avg = (double)live / frames;
+        if (allocs != 0 || avg < target * 0.8 || avg > target * 1.2 || ps.overwritten) {
+            fprintf(stderr, "bench: particles didn't hold %d without allocating (avg %.0f, %ld allocs, %d overwritten)\n",
+                    target, avg, allocs, ps.overwritten);
+            ok = 0;
+        }
+        printf("%-10s %10d %10.0f %12.0f %10.2f %12.0f %6d %7.1f%% %8ld\n", "particles", target, avg, update / frames * 1e9,
+               update / frames * 1e9 / avg, build / frames * 1e9, RenderDrawCalls(&r),
+               (update + build) / frames / dt * 100.0, allocs);
+    }
+
+    ParticlesFree(&ps);
+    RenderFree(&r);
+    return ok ? 0 : 1;
+}
+
+// FNV over FxSin/FxCos at every angle, FxAtan2 and FxNormalize over a grid of vectors.
+// any change to the tables or the integer math changes it
+#define FIXED_CHECKSUM 0x4d0f95461c5a2d6bull
+
+static uint64_t FixedChecksum(void) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (int a = 0; a < FX_TURN; ++a) {
+        uint32_t v[2] = { (uint32_t)FxSin((uint16_t)a), (uint32_t)FxCos((uint16_t)a) };
+        for (int k = 0; k < 2; ++k) { h ^= v[k]; h *= 0x100000001B3ull; }
+    }
+    for (int y = -600; y <= 600; y += 7) {
+        for (int x = -1000; x <= 1000; x += 9) {
+            Fixed fx = x * (FX_ONE / 4) + 123, fy = y * (FX_ONE / 4) - 77;
+            uint32_t ang = FxAtan2(fy, fx);
+            FxNormalize(&fx, &fy);
+            uint32_t v[3] = { ang, (uint32_t)fx, (uint32_t)fy };
+            for (int k = 0; k < 3; ++k) { h ^= v[k]; h *= 0x100000001B3ull; }
+        }
+    }
+    return h;
+}
+
+static int BenchFixed(void) {
+    const int n = 1 << 20;
+    float *fx = MemAlloc(MEM_OTHER, sizeof(float) * (size_t)n), *fy = MemAlloc(MEM_OTHER, sizeof(float) * (size_t)n);
+    if (!fx || !fy) {
+        fprintf(stderr, "bench: out of memory\n");
+        MemFree(fx); MemFree(fy);
+        return 1;
+    }
+    for (int i = 0; i < n; ++i) { fx[i] = RandF(-SCREEN_W, SCREEN_W); fy[i] = RandF(-SCREEN_H, SCREEN_H); }
+
+    // worst error against double-precision libm
+    double sinErr = 0.0, atanErr = 0.0, unitErr = 0.0;
+    for (int a = 0; a < FX_TURN; ++a) {
+        double r = a * (2.0 * SIM_PI / FX_TURN);
+        double e = fabs(FxToFloat(FxSin((uint16_t)a)) - sin(r));
+        double c = fabs(FxToFloat(FxCos((uint16_t)a)) - cos(r));
+        if (e > sinErr) sinErr = e;
+        if (c > sinErr) sinErr = c;
+    }
+    for (int i = 0; i < n; ++i) {
+        Fixed x = FxFromFloat(fx[i]), y = FxFromFloat(fy[i]);
+        double want = atan2((double)y, (double)x) * (180.0 / SIM_PI);
+        double got = (int16_t)FxAtan2(y, x) * (360.0 / FX_TURN);
+        double d = fabs(got - want);
+        if (d > 180.0) d = 360.0 - d;
+        if (d > atanErr) atanErr = d;
+        if (!FxNormalize(&x, &y)) continue;
+        d = fabs(sqrt((double)FxToFloat(x) * FxToFloat(x) + (double)FxToFloat(y) * FxToFloat(y)) - 1.0);
+        if (d > unitErr) unitErr = d;
+    }
+
+    // ns per call (the sink keeps the loops from being thrown away)
+    volatile float sink = 0.0f;
+    float acc = 0.0f;
+    double t0 = NowSeconds();
+    for (int i = 0; i < n; ++i) { float a = atan2f(fy[i], fx[i]); acc += cosf(a) + sinf(a); }
+    double t1 = NowSeconds();
+    for (int i = 0; i < n; ++i) {
+        uint16_t a = FxAtan2(FxFromFloat(fy[i]), FxFromFloat(fx[i]));
+        acc += FxToFloat(FxCos(a) + FxSin(a));
+    }
+    double t2 = NowSeconds();
+    for (int i = 0; i < n; ++i) { float len = sqrtf(fx[i]*fx[i] + fy[i]*fy[i]); acc += fx[i] / len + fy[i] / len; }
+    double t3 = NowSeconds();
+    for (int i = 0; i < n; ++i) {
+        Fixed x = FxFromFloat(fx[i]), y = FxFromFloat(fy[i]);
+        FxNormalize(&x, &y);
+        acc += FxToFloat(x + y);
+    }
+    double t4 = NowSeconds();
+    sink = acc;
+    (void)sink;
+
+    uint64_t sum = FixedChecksum();
+    int ok = sum == FIXED_CHECKSUM && sinErr < 3e-5 && atanErr < 0.01 && unitErr < 1e-4;
+    if (!ok) {
+        fprintf(stderr, "bench: fixed math off (checksum %016llx, want %016llx, sin err %.2g, atan2 err %.3g deg, unit err %.2g)\n",
+                (unsigned long long)sum, FIXED_CHECKSUM, sinErr, atanErr, unitErr);
+    }
+    printf("%-10s %14s %14s %12s\n", "fixed", "libm_ns/call", "fixed_ns/call", "max_err");
+    printf("%-10s %14.2f %14.2f %12.2g\n", "aim_trig", (t1 - t0) * 1e9 / n, (t2 - t1) * 1e9 / n, sinErr);
+    printf("%-10s %14s %14s %12.3g deg\n", "atan2_err", "", "", atanErr);
+    printf("%-10s %14.2f %14.2f %12.2g\n", "normalize", (t3 - t2) * 1e9 / n, (t4 - t3) * 1e9 / n, unitErr);
+    printf("checksum   %016llx %s\n", (unsigned long long)sum, sum == FIXED_CHECKSUM ? "ok" : "MISMATCH");
+
+    MemFree(fx); MemFree(fy);
+    return ok ? 0 : 1;
+}
+
+// producer side of the ring test: t = 0, 1, 2... spinning (politely) while it's full
+typedef struct {
+    InputQueue *q;
+    uint64_t count;
+} RingFeed;
+
+static void *RingFeedMain(void *arg) {
+    RingFeed *f = arg;
+    for (uint64_t i = 0; i < f->count; ++i) {
+        InputSample s = { i, { (float)(i & 1023), 0.0f }, (i & 1) != 0, false };
+        while (!InputQueuePush(f->q, &s)) sched_yield();
+    }
+    return NULL;
+}
+
+static int BenchInput(void) {
+    static InputQueue q;
+    const uint64_t count = 2000000;
+    InputSample s;
+    int ok = 1;
+
+    // one thread: what a push + pop pair costs with no contention
+    InputQueueInit(&q);
+    double t0 = NowSeconds();
+    for (uint64_t i = 0; i < count; ++i) {
+        s.t = i;
+        InputQueuePush(&q, &s);
+        if (!InputQueuePeek(&q, &s) || s.t != i) ok = 0;
+        InputQueuePop(&q);
+    }
+    double local = NowSeconds() - t0;
+
+    // two threads. a full ring makes the producer retry, so dropped counts those too
+    InputQueueInit(&q);
+    RingFeed feed = { &q, count };
+    pthread_t producer;
+    t0 = NowSeconds();
+    if (pthread_create(&producer, NULL, RingFeedMain, &feed) != 0) {
+        fprintf(stderr, "bench: can't start the producer thread\n");
+        return 1;
+    }
+    uint64_t next = 0;
+    while (next < count) {
+        if (!InputQueuePeek(&q, &s)) { sched_yield(); continue; }
+        if (s.t != next || s.fire != ((next & 1) != 0) || s.aim.x != (float)(next & 1023)) ok = 0;
+        InputQueuePop(&q);
+        next++;
+    }
+    pthread_join(producer, NULL);
+    double cross = NowSeconds() - t0;
+
+    if (!ok) fprintf(stderr, "bench: input ring lost or reordered samples\n");
+    printf("%-10s %10s %14s %12s\n", "input", "samples", "ns/sample", "full_retries");
+    printf("%-10s %10llu %14.2f %12s\n", "1_thread", (unsigned long long)count, local * 1e9 / count, "-");
+    printf("%-10s %10llu %14.2f %12u\n", "2_threads", (unsigned long long)count, cross * 1e9 / count, q.dropped);
+    return ok ? 0 : 1;
+}
+
+// the peer's real input at tick t: fire flips every `run` ticks, so the held guess is
+// wrong right at the start of every batch
+static SimInput PeerAt(uint32_t t, int run) {
+    SimInput in = { .aim = { 300.0f + (float)(t % 7), 200.0f }, .fire = (t / (uint32_t)run) % 2 == 0 };
+    return in;
+}
+
+static void Swarm(GameState *s, int n);
+static void SetupLateGame(GameState *s);
+
+static int BenchRollback(void) {
+    const int sizes[] = { 1000, 10000, 50000 };
+    const int lengths[] = { 1, 8, NET_WINDOW };
+    static GameState game, ref;
+    static NetSession ns;
+    const float step = 1.0f / SIM_TICK_HZ;
+    int ok = 1;
+
+    printf("%-10s %10s %8s %12s %12s %12s %14s\n", "scenario", "entities", "ticks", "step_ns", "net_tick_ns",
+           "rollback_ms", "resim/frame");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        for (size_t j = 0; j < sizeof(lengths) / sizeof(lengths[0]); ++j) {
+            int run = lengths[j];
+            if (!SimInit(&game, 0, 99) || !SimInit(&ref, 0, 99)) {
+                fprintf(stderr, "bench: out of memory\n");
+                return 1;
+            }
+            SimSetPlayers(&game, 2);
+            SimSetPlayers(&ref, 2);
+            benchSeed = 99;
+            Swarm(&game, sizes[i]);
+            game.weapon = SIM_WEAPON_SHOTGUN;
+            Snapshot start = {0};
+            if (!SnapshotSave(&start, &game) || !SnapshotRestore(&start, &ref) ||
+                !NetSessionInit(&ns, &game, NULL, 0, 0, SIM_TICK_HZ)) {
+                fprintf(stderr, "bench: out of memory\n");
+                return 1;
+            }
+            SnapshotFree(&start);
+
+            // batches of `run` ticks on a guess (one tick per frame), then the real inputs
+            // show up. the first batch only warms up the snapshot buffers
+            const int batches = 9;
+            SimInput local = { .aim = { 100.0f, 100.0f }, .fire = true };
+            double fwd = 0.0, back = 0.0, bare = 0.0;
+            double entities = 0.0;
+            uint32_t timedFrom = 0, resimFrom = 0;
+            for (int b = 0; b < batches; ++b) {
+                if (b == 1) { fwd = back = bare = 0.0; entities = 0.0; timedFrom = ns.tick; resimFrom = ns.resimTicks; }
+                uint32_t first = ns.tick;
+                double t0 = NowSeconds();
+                for (int k = 0; k < run; ++k) NetAdvance(&ns, &local, step);
+                fwd += NowSeconds() - t0;
+
+                SimInput late[NET_WINDOW];
+                for (uint32_t k = first; k < ns.tick; ++k) late[k - first] = PeerAt(k, run);
+                NetReceiveInputs(&ns, first, (int)(ns.tick - first), late);
+                entities += game.enemies.count + game.bullets.count;
+                t0 = NowSeconds();
+                NetAdvance(&ns, &local, 0.0f);
+                back += NowSeconds() - t0;
+
+                // the same ticks with every input on time
+                for (uint32_t k = first; k < ns.tick; ++k) {
+                    SimInput in[2] = { local, PeerAt(k, run) };
+                    t0 = NowSeconds();
+                    SimStep(&ref, in, step);
+                    bare += NowSeconds() - t0;
+                }
+            }
+            if (SimHash(&game) != SimHash(&ref) || ns.rollbacks != (uint32_t)batches) {
+                fprintf(stderr, "bench: rollback of %d ticks at %d entities didn't match the on-time run\n", run, sizes[i]);
+                ok = 0;
+            }
+            double ticks = (double)(ns.tick - timedFrom);
+            double perTick = back / (ns.resimTicks - resimFrom);
+            printf("%-10s %10.0f %8d %12.0f %12.0f %12.3f %14.0f\n", "rollback", entities / (batches - 1), run,
+                   bare * 1e9 / ticks, fwd * 1e9 / ticks, back * 1e3 / (batches - 1), (1.0 / 60.0) / perTick);
+            NetSessionFree(&ns);
+            SimFree(&game); SimFree(&ref);
+        }
+    }
+    return ok ? 0 : 1;
+}
+
+// ticks of the scenario loop: fire held, aim sweeping around
+static double RunTicks(GameState *s, int ticks) {
+    double secs = 0.0;
+    for (int t = 0; t < ticks; ++t) {
+        float ang = t * 0.05f;
+        SimInput in = { .aim = { s->player[0].x + cosf(ang) * 200.0f, s->player[0].y + sinf(ang) * 200.0f }, .fire = true };
+        double t0 = NowSeconds();
+        SimStep(s, &in, 1.0f / SIM_TICK_HZ);
+        secs += NowSeconds() - t0;
+    }
+    return secs;
+}
+
+// reads the log back: records per kind and enemies spawned. false if it isn't a
+// complete log
+static bool ReadLog(const char *path, long kinds[TEL_KIND_COUNT], long *spawned) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    unsigned char *data = size > 0 ? malloc((size_t)size) : NULL;
+    bool ok = data && fread(data, 1, (size_t)size, f) == (size_t)size;
+    fclose(f);
+
+    TelReader r;
+    TelRecord rec;
+    memset(kinds, 0, sizeof(long) * TEL_KIND_COUNT);
+    *spawned = 0;
+    if (ok && TelReaderInit(&r, data, (size_t)size)) {
+        while (TelReaderNext(&r, &rec)) {
+            kinds[rec.kind]++;
+            if (rec.kind == TEL_SPAWN) *spawned += rec.a;
+        }
+        ok = !r.truncated && kinds[TEL_END] == 1;
+    } else {
+        ok = false;
+    }
+    free(data);
+    return ok;
+}
+
+static int BenchTelemetry(void) {
+    const char *path = "bin/bench_telemetry.ntt";
+    static GameState s;
+    static Telemetry tel;
+    struct { const char *name; int ticks, swarm; } runs[] = { { "late_game", 20000, 0 }, { "swarm_10k", 600, 10000 } };
+    int ok = 1;
+
+    printf("%-10s %-10s %8s %12s %12s %9s %10s %10s %8s\n", "telemetry", "scenario", "ticks", "off_ns/tick", "on_ns/tick",
+           "overhead", "records", "bytes/tick", "dropped");
+    for (size_t i = 0; i < sizeof(runs) / sizeof(runs[0]); ++i) {
+        double secs[2];
+        uint64_t hash[2];
+        long kills = 0;
+        for (int on = 0; on < 2; ++on) {
+            benchSeed = 1234;
+            if (!SimInit(&s, 0, 1234)) {
+                fprintf(stderr, "bench: out of memory\n");
+                return 1;
+            }
+            if (runs[i].swarm) Swarm(&s, runs[i].swarm);
+            else SetupLateGame(&s);
+            int score0 = s.score;
+            if (on) {
+                if (!TelemetryOpen(&tel, path, 1234, SIM_TICK_HZ, s.tick)) {
+                    fprintf(stderr, "bench: can't write %s\n", path);
+                    return 1;
+                }
+                s.telemetry = &tel;
+            }
+            secs[on] = RunTicks(&s, runs[i].ticks);
+            hash[on] = SimHash(&s);
+            kills = (s.score - score0) / 10;
+            if (on) {
+                TelemetryClose(&tel);
+                long kinds[TEL_KIND_COUNT], spawned = 0;
+                if (!ReadLog(path, kinds, &spawned) || kinds[TEL_KILL] != kills || spawned != (long)s.spawnIndex ||
+                    tel.dropped || tel.writeFailures) {
+                    fprintf(stderr, "bench: %s log doesn't match the run (%ld of %ld kills, %ld of %llu spawns, %u dropped)\n",
+                            runs[i].name, kinds[TEL_KILL], kills, spawned, (unsigned long long)s.spawnIndex, tel.dropped);
+                    ok = 0;
+                }
+            }
+            SimFree(&s);
+        }
+        if (hash[0] != hash[1]) {
+            fprintf(stderr, "bench: %s plays differently with telemetry on\n", runs[i].name);
+            ok = 0;
+        }
+        printf("%-10s %-10s %8d %12.0f %12.0f %8.1f%% %10llu %10.2f %8u\n", "telemetry", runs[i].name, runs[i].ticks,
+               secs[0] * 1e9 / runs[i].ticks, secs[1] * 1e9 / runs[i].ticks, (secs[1] / secs[0] - 1.0) * 100.0,
+               (unsigned long long)tel.records, (double)tel.bytes / runs[i].ticks, tel.dropped);
+    }
+
+    // the writer on its own: as many kill records as it takes, one tick per 64
+    const int flood = 4000000;
+    if (!TelemetryOpen(&tel, path, 1, SIM_TICK_HZ, 0)) return 1;
+    double t0 = NowSeconds();
+    for (int i = 0; i < flood; ++i)
+        TelemetryKill(&tel, (uint32_t)(i / 64), (float)(i % 960), (float)(i % 540), (float)(i % 960) + 3.0f, (float)(i % 540), 1.0f, 0.5f);
+    double secs = NowSeconds() - t0;
+    TelemetryClose(&tel);
+    printf("%-10s %-10s %8d %12s %12.1f %9s %10llu %10.2f %8u   (ns/record, bytes/record)\n", "telemetry", "flood", flood, "-",
+           secs * 1e9 / flood, "-", (unsigned long long)tel.records, (double)tel.bytes / tel.records, tel.dropped);
+    remove(path);
+    return ok ? 0 : 1;
+}
+
+// a volley with no spawns and no more shots: n enemies closing in (Swarm) and `shots`
+// bullets already in the air, so everything moves in a straight line and only the
+// collision pass decides who dies
+static bool SetupVolley(GameState *s, int enemies, int shots) {
+    benchSeed = 1234;
+    if (!SimInit(s, 0, 1234)) return false;
+    Swarm(s, enemies);
+    s->tune.spawnBase = s->tune.spawnMin = 1e9f;
+    for (int i = 0; i < shots; ++i) {
+        float ang = RandF(0.0f, 2.0f * SIM_PI);
+        PoolPush(&s->bullets, RandF(0.0f, SCREEN_W), RandF(0.0f, SCREEN_H), cosf(ang) * BULLET_SPEED,
+                 sinf(ang) * BULLET_SPEED, RandF(0.1f, BULLET_LIFETIME));
+    }
+    return true;
+}
+
+// the fan the way it used to be done: atan2 for the aim, then a cos/sin (and a
+// normalize) per pellet
+static void TrigFan(EntityPool *p, Vec2 from, Vec2 aim, int n, float spreadDeg, float speed, float life) {
+    float base = atan2f(aim.y - from.y, aim.x - from.x), spread = spreadDeg * (SIM_PI / 180.0f);
+    for (int i = 0; i < n; ++i) {
+        float t = n == 1 ? 0.0f : (float)i / (float)(n - 1);
+        float a = base + (t - 0.5f) * 2.0f * spread;
+        float dx = cosf(a), dy = sinf(a), len = sqrtf(dx * dx + dy * dy);
+        PoolPush(p, from.x, from.y, dx / len * speed, dy / len * speed, life);
+    }
+}
+
+// a batch of shots from every weapon through SimFire (the fan tables) and through the
+// trig fan: ns per shot, and how far apart their pellets' velocities end up
+static int BenchWeapons(void) {
+    static GameState s;
+    static EntityPool ref;
+    const int batch = 64, batches = 400;        // pools cleared between batches
+    if (!SimInit(&s, 0, 7) || !PoolInit(&ref, batch * WEAPON_MAX_PELLETS) ||
+        !PoolReserve(&s.bullets, batch * WEAPON_MAX_PELLETS)) {
+        fprintf(stderr, "bench: out of memory\n");
+        return 1;
+    }
+    const SimTuning *t = &s.tune;
+    struct { const char *name; int pellets; float spread, speed; } rows[] = {
+#define WEAPON_ROW(id, name, rate, pellets, spread, speed, life, blast) { name, pellets, spread, speed },
+        SIM_WEAPONS(WEAPON_ROW)
+#undef WEAPON_ROW
+    };
+    Vec2 aims[64];
+    for (int i = 0; i < 64; ++i) {
+        float a = i * 0.37f;
+        aims[i] = (Vec2){ s.player[0].x + cosf(a) * (40.0f + i * 5.0f), s.player[0].y + sinf(a) * (40.0f + i * 3.0f) };
+    }
+
+    int ok = 1;
+    printf("%-10s %-10s %8s %12s %12s %10s %8s %10s %8s\n", "scenario", "weapon", "pellets", "table_ns", "trig_ns",
+           "ns/pellet", "speedup", "max_err", "allocs");
+    for (int w = 0; w < SIM_WEAPON_COUNT; ++w) {
+        s.weapon = w;
+        double table = 0.0, trig = 0.0;
+        float err = 0.0f;
+        MemStats before = {0};
+        for (int b = 0; b <= batches; ++b) {       // batch 0 warms up
+            if (b == 1) before = MemGetStats();
+            PoolClear(&s.bullets);
+            ChunkListClear(&s.traces);
+            double t0 = NowSeconds();
+            for (int i = 0; i < batch; ++i) SimFire(&s, 0, aims[i]);
+            double t1 = NowSeconds();
+            PoolClear(&ref);
+            for (int i = 0; i < batch; ++i) TrigFan(&ref, s.player[0], aims[i], rows[w].pellets, rows[w].spread, rows[w].speed, 0.6f);
+            double t2 = NowSeconds();
+            if (b > 0) { table += t1 - t0; trig += t2 - t1; }
+
+            // same directions as the trig fan, to float rounding (or the fixed tables)
+            for (int i = 0; b == 1 && i < ref.count && i < s.bullets.count; ++i) {
+                float ex = fabsf(POOL_GET(&s.bullets, vx, i) - POOL_GET(&ref, vx, i));
+                float ey = fabsf(POOL_GET(&s.bullets, vy, i) - POOL_GET(&ref, vy, i));
+                if (ex > err) err = ex;
+                if (ey > err) err = ey;
+            }
+            if (b == 1 && s.bullets.count != ref.count) err = 1e9f;
+        }
+        err /= rows[w].speed;
+        long allocs = (long)(MemGetStats().allocs - before.allocs);
+        double shots = (double)batch * batches;
+        if (err > 1e-3f || allocs != 0) {
+            fprintf(stderr, "bench: %s fan is off the trig one by %g (or allocated, %ld)\n", rows[w].name, err, allocs);
+            ok = 0;
+        }
+        printf("%-10s %-10s %8d %12.1f %12.1f %10.2f %7.1fx %10.2e %8ld\n", "weapons", rows[w].name, rows[w].pellets,
+               table / shots * 1e9, trig / shots * 1e9, table / shots * 1e9 / rows[w].pellets, trig / table, err, allocs);
+    }
+    PoolFree(&ref);
+    SimFree(&s);
+    return ok ? 0 : 1;
+}
+
+// the same volleys and a late game stepped at 240 Hz (the reference) down to 20 Hz:
+// kills and which enemies died have to match the reference, and the cost of a
+// sim-second shows what the low rates save
+static int BenchTickRate(void) {
+    const int rates[] = { 240, 120, 60, 30, 20 };
+    struct { const char *name; int enemies, shots; } volleys[] = { { "volley_40", 40, 100 }, { "volley_1k", 1000, 1000 } };
+    static GameState s;
+    static unsigned char alive[2][4096];
+    int ok = 1;
+
+    printf("%-10s %-10s %6s %8s %10s %10s %12s\n", "tickrate", "scenario", "hz", "kills", "vs_240", "fate_diff", "ms/sim_s");
+    for (size_t v = 0; v < sizeof(volleys) / sizeof(volleys[0]); ++v) {
+        int refKills = 0;
+        for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); ++r) {
+            int hz = rates[r], ticks = hz;      // one sim-second, every bullet is gone by then
+            if (!SetupVolley(&s, volleys[v].enemies, volleys[v].shots)) {
+                fprintf(stderr, "bench: out of memory\n");
+                return 1;
+            }
+            SimInput idle = { .aim = { 0.0f, 0.0f }, .fire = false };
+            double t0 = NowSeconds();
+            for (int t = 0; t < ticks; ++t) SimStep(&s, &idle, 1.0f / (float)hz);
+            double secs = NowSeconds() - t0;
+
+            // enemy i took handle slot i (nothing else was ever pushed)
+            unsigned char *mine = alive[r == 0 ? 0 : 1];
+            for (int i = 0; i < volleys[v].enemies; ++i) mine[i] = s.enemies.denseOf[i] >= 0;
+            int kills = s.score / 10, diff = 0;
+            if (r == 0) refKills = kills;
+            for (int i = 0; i < volleys[v].enemies; ++i) diff += alive[0][i] != mine[i];
+            printf("%-10s %-10s %6d %8d %+9.1f%% %10d %12.3f\n", "tickrate", volleys[v].name, hz, kills,
+                   refKills ? (kills - refKills) * 100.0 / refKills : 0.0, diff, secs * 1e3);
+            // a slower tick may settle a close call the other way, but not lose hits
+            if (abs(kills - refKills) * 50 > refKills || diff * 20 > volleys[v].enemies) {
+                fprintf(stderr, "bench: %s at %d Hz doesn't hit what 240 Hz hits (%d kills vs %d, %d differ)\n",
+                        volleys[v].name, hz, kills, refKills, diff);
+                ok = 0;
+            }
+            SimFree(&s);
+        }
+    }
+
+    // what a sim-second of a late game costs at each rate
+    const float simSeconds = 60.0f;
+    for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); ++r) {
+        int hz = rates[r], ticks = (int)(simSeconds * hz);
+        benchSeed = 1234;
+        if (!SimInit(&s, 0, 1234)) return 1;
+        SetupLateGame(&s);
+        double secs = 0.0;
+        for (int t = 0; t < ticks; ++t) {
+            float ang = (float)t / (float)hz * 6.0f;      // same sweep in sim time at every rate
+            SimInput in = { .aim = { s.player[0].x + cosf(ang) * 200.0f, s.player[0].y + sinf(ang) * 200.0f }, .fire = true };
+            double t0 = NowSeconds();
+            SimStep(&s, &in, 1.0f / (float)hz);
+            secs += NowSeconds() - t0;
+        }
+        printf("%-10s %-10s %6d %8d %10s %10s %12.3f\n", "tickrate", "late_game", hz, s.score / 10 - SHOTGUN_UNLOCK_AFTER_SCORE / 10,
+               "-", "-", secs * 1e3 / simSeconds);
+        SimFree(&s);
+    }
+    return ok ? 0 : 1;
+}
+
+// ---- scenarios ----
+
+typedef struct {
+    const char *name;
+    int ticks;
+    void (*setup)(GameState *s);
+    void (*beforeTick)(GameState *s);    // optional, runs untimed before every tick
+} Scenario;
+
+// can't die, so the run doesn't end in a game over halfway through
+static void Immortal(GameState *s) {
+    s->hp = INT_MAX / 2;
+}
+
+static void SetupLateGame(GameState *s) {
+    Immortal(s);
+    s->timeSinceStart = 600.0f;
+    s->weapon = SIM_WEAPON_SHOTGUN;
+    s->score = SHOTGUN_UNLOCK_AFTER_SCORE;
+}
+
+static void SetupShotgun(GameState *s) {
+    Immortal(s);
+    s->weapon = SIM_WEAPON_SHOTGUN;
+    s->score = SHOTGUN_UNLOCK_AFTER_SCORE;
+}
+
+static void SetupFlak(GameState *s) {
+    Immortal(s);
+    s->weapon = SIM_WEAPON_FLAK;
+}
+
+static void FireEveryTick(GameState *s) {
+    s->fireCooldown[0] = 0.0f;
+}
+
+// n enemies on rings around the player, all heading in
+static void Swarm(GameState *s, int n) {
+    Immortal(s);
+    s->timeSinceStart = 600.0f;
+    for (int i = 0; i < n; ++i) {
+        float ang = RandF(0.0f, 2.0f * SIM_PI);
+        float r = RandF(60.0f, 0.5f * SCREEN_W);
+        float x = s->player[0].x + cosf(ang) * r, y = s->player[0].y + sinf(ang) * r;
+        PoolPush(&s->enemies, x, y, -cosf(ang) * ENEMY_SPEED_MAX, -sinf(ang) * ENEMY_SPEED_MAX, 0.0f);
+    }
+}
+
+static void SetupSwarm10k(GameState *s)  { Swarm(s, 10000); }
+static void SetupSwarm100k(GameState *s) { Swarm(s, 100000); }
+
+static void SetupStorm(GameState *s) {
+    Immortal(s);
+}
+
+static void SpawnEveryTick(GameState *s) {
+    s->spawnOwed = 1.0f;
+    s->timeSinceStart = 0.0f;     // keep enemies slow so they pile up
+}
+
+// room for all of them up front, so the timed ticks measure spawning, not pool growth
+static void SetupFlood(GameState *s) {
+    Immortal(s);
+    PoolReserve(&s->enemies, 130000);
+}
+
+// a thousand more every tick through the bulk spawner
+static void SpawnFlood(GameState *s) {
+    s->timeSinceStart = 0.0f;
+    SimSpawnEnemies(s, 1000);
+}
+
+static const Scenario scenarios[] = {
+    { "late_game",    20000, SetupLateGame,  NULL },
+    { "shotgun_spam",  5000, SetupShotgun,   FireEveryTick },
+    { "flak_spam",     5000, SetupFlak,      FireEveryTick },
+    { "swarm_10k",      600, SetupSwarm10k,  NULL },
+    { "swarm_100k",     120, SetupSwarm100k, NULL },
+    { "spawn_storm",  20000, SetupStorm,     SpawnEveryTick },
+    { "spawn_flood",    120, SetupFlood,     SpawnFlood },
+};
+
+static long MaxRssKb(void) {
+    struct rusage ru;
+    return getrusage(RUSAGE_SELF, &ru) == 0 ? ru.ru_maxrss : 0;
+}
+
+static int RunScenario(const Scenario *sc, const char *tag, FILE *csv) {
+    static GameState s;
+    benchSeed = 1234;
+    if (!SimInit(&s, 0, 1234)) {
+        fprintf(stderr, "bench: out of memory\n");
+        return 1;
+    }
+    sc->setup(&s);
+    MemResetPeak();
+    MemStats m0 = MemGetStats();
+
+    double secs = 0.0;
+    double entityTicks = 0.0;
+    for (int t = 0; t < sc->ticks; ++t) {
+        if (sc->beforeTick) sc->beforeTick(&s);
+        float ang = t * 0.05f;     // sweep the aim around
+        SimInput in = { .aim = { s.player[0].x + cosf(ang) * 200.0f, s.player[0].y + sinf(ang) * 200.0f }, .fire = true };
+        entityTicks += s.enemies.count + s.bullets.count;
+
+        double t0 = NowSeconds();
+        SimStep(&s, &in, 1.0f / SIM_TICK_HZ);
+        secs += NowSeconds() - t0;
+    }
+
+    MemStats m1 = MemGetStats();
+    double nsTick = secs * 1e9 / sc->ticks;
+    double avgEntities = entityTicks / sc->ticks;
+    double nsEntity = entityTicks > 0 ? secs * 1e9 / entityTicks : 0.0;
+    unsigned long long allocs = (unsigned long long)(m1.allocs - m0.allocs);
+    long long peak = (long long)m1.peakBytes;
+    printf("%-14s %8d %12.0f %10.2f %12.0f %8llu %12lld %10ld\n", sc->name, sc->ticks, nsTick, nsEntity,
+           avgEntities, allocs, peak, MaxRssKb());
+    if (csv) {
+        fprintf(csv, "%s,%s,%d,%.1f,%.3f,%.1f,%llu,%lld,%ld\n", tag, sc->name, sc->ticks, nsTick, nsEntity,
+                avgEntities, allocs, peak, MaxRssKb());
+    }
+    SimFree(&s);
+    return 0;
+}
+
+// a few bounded scenarios with the frame side too (RenderBuild, particles) every tick:
+// what each subsystem holds and peaks at, and its allocations during the first half
+// (warm-up) and the second (steady state, has to be none)
+static int BenchMemory(void) {
+    const char *runs[] = { "late_game", "shotgun_spam", "flak_spam", "swarm_10k" };
+    static GameState s;
+    static RenderList r;
+    static ParticleSystem ps;
+    int ok = 1;
+
+    printf("%-10s %-14s %-10s %10s %10s %12s %12s\n", "memory", "scenario", "subsystem", "now_kb", "peak_kb",
+           "warm_allocs", "steady_allocs");
+    for (size_t i = 0; i < sizeof(runs) / sizeof(runs[0]); ++i) {
+        const Scenario *sc = NULL;
+        for (size_t j = 0; j < sizeof(scenarios) / sizeof(scenarios[0]); ++j)
+            if (strcmp(scenarios[j].name, runs[i]) == 0) sc = &scenarios[j];
+        benchSeed = 1234;
+        if (!sc || !SimInit(&s, 0, 1234) || !ParticlesInit(&ps, 1)) {
+            fprintf(stderr, "bench: out of memory\n");
+            return 1;
+        }
+        RenderInit(&r);
+        sc->setup(&s);
+        MemResetPeak();
+
+        MemCounts start = MemGetCounts(), mid = start;
+        for (int t = 0; t < sc->ticks; ++t) {
+            if (t == sc->ticks / 2) mid = MemGetCounts();
+            if (sc->beforeTick) sc->beforeTick(&s);
+            float ang = t * 0.05f;
+            SimInput in = { .aim = { s.player[0].x + cosf(ang) * 200.0f, s.player[0].y + sinf(ang) * 200.0f }, .fire = true };
+            SimStep(&s, &in, 1.0f / SIM_TICK_HZ);
+            ParticlesEmitFx(&ps, &s);
+            ParticlesUpdate(&ps, 1.0f / SIM_TICK_HZ);
+            RenderBuild(&r, &s, 1.0f, (Vec2){ 0.0f, 0.0f });
+            RenderAddParticles(&r, &ps, (Vec2){ 0.0f, 0.0f });
+        }
+        MemCounts end = MemGetCounts();
+
+        for (int t = 0; t < MEM_TAG_COUNT; ++t) {
+            MemStats st = MemGetTagStats((MemTag)t);
+            unsigned long long warm = (unsigned long long)(mid.allocs[t] - start.allocs[t]);
+            unsigned long long steady = (unsigned long long)(end.allocs[t] - mid.allocs[t]);
+            if (st.peakBytes == 0 && warm == 0 && steady == 0) continue;
+            printf("%-10s %-14s %-10s %10.1f %10.1f %12llu %12llu\n", "memory", sc->name, MemTagName((MemTag)t),
+                   st.bytes / 1024.0, st.peakBytes / 1024.0, warm, steady);
+            if (steady) {
+                fprintf(stderr, "bench: %s allocated %llu times in %s's steady state\n", MemTagName((MemTag)t), steady, sc->name);
+                ok = 0;
+            }
+        }
+        RenderFree(&r);
+        ParticlesFree(&ps);
+        SimFree(&s);
+    }
+    return ok ? 0 : 1;
+}
+
+static bool Wanted(const char *name, char **names, int count) {
+    if (count == 0) return true;
+    for (int i = 0; i < count; ++i) {
+        if (strcmp(names[i], name) == 0) return true;
+    }
+    return false;
+}
+
+int main(int argc, char **argv) {
+    const char *csvPath = NULL, *tag = "local";
+    char *names[64];
+    int nameCount = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)      csvPath = argv[++i];
+        else if (strcmp(argv[i], "--tag") == 0 && i + 1 < argc) tag = argv[++i];
+        else if (argv[i][0] == '-') {
+            fprintf(stderr, "usage: %s [--csv out.csv] [--tag name] [benchmark...]\n", argv[0]);
+            return 1;
+        }
+        else if (nameCount < 64) names[nameCount++] = argv[i];
+    }
+
+    int rc = 0;
+    if (Wanted("collide", names, nameCount)) { rc |= BenchCollide(); printf("\n"); }
+    if (Wanted("update", names, nameCount))  { rc |= BenchUpdate();  printf("\n"); }
+    if (Wanted("render", names, nameCount))  { rc |= BenchRender();  printf("\n"); }
+    if (Wanted("threads", names, nameCount)) { rc |= BenchThreads(); printf("\n"); }
+    if (Wanted("scores", names, nameCount))  { rc |= BenchScores();  printf("\n"); }
+    if (Wanted("snapshot", names, nameCount)) { rc |= BenchSnapshot(); printf("\n"); }
+    if (Wanted("particles", names, nameCount)) { rc |= BenchParticles(); printf("\n"); }
+    if (Wanted("fixed", names, nameCount))   { rc |= BenchFixed();   printf("\n"); }
+    if (Wanted("input", names, nameCount))   { rc |= BenchInput();   printf("\n"); }
+    if (Wanted("rollback", names, nameCount)) { rc |= BenchRollback(); printf("\n"); }
+    if (Wanted("telemetry", names, nameCount)) { rc |= BenchTelemetry(); printf("\n"); }
+    if (Wanted("tickrate", names, nameCount)) { rc |= BenchTickRate(); printf("\n"); }
+    if (Wanted("weapons", names, nameCount))  { rc |= BenchWeapons();  printf("\n"); }
+    if (Wanted("memory", names, nameCount))   { rc |= BenchMemory();   printf("\n"); }
+
+    FILE *csv = NULL;
+    if (csvPath) {
+        csv = fopen(csvPath, "a");
+        if (!csv) {
+            fprintf(stderr, "bench: can't write %s\n", csvPath);
+            return 1;
+        }
+        fseek(csv, 0, SEEK_END);
+        if (ftell(csv) == 0) fprintf(csv, "tag,scenario,ticks,ns_per_tick,ns_per_entity,avg_entities,allocs,peak_bytes,maxrss_kb\n");
+    }
+
+    bool header = false;
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); ++i) {
+        if (!Wanted(scenarios[i].name, names, nameCount)) continue;
+        if (!header) {
+            printf("%-14s %8s %12s %10s %12s %8s %12s %10s\n", "scenario", "ticks", "ns/tick", "ns/entity",
+                   "avg_entities", "allocs", "peak_bytes", "maxrss_kb");
+            header = true;
+        }
+        rc |= RunScenario(&scenarios[i], tag, csv);
+    }
+    if (csv) fclose(csv);
+    return rc;
+}
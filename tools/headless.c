@@ -0,0 +1,516 @@
+// NULL TERMINATOR — headless driver
+// Runs the sim with no window and no GPU, as fast as it will go.
+// By default the bot (src/bot.c) aims at the closest enemy and holds fire, restarts on game over.
+//
+// usage: bin/headless [--ticks N] [--hz N] [--seed N] [--threads N] [--record file.ntr]
+//                     [--csv prof.csv] [--trace prof.json] [--rewind N] [--telemetry log.ntt]
+//                     [--alloc-check N]
+//        bin/headless --replay file.ntr
+//        bin/headless --input-test seconds [--input-hz N]
+//        bin/headless --coop 0|1 --port P --peer-port Q [--ticks N] [--delay N]
+//                     [--lag ms] [--jitter ms] [--loss pct]
+//   with `make PROFILE=1` it also prints p50/p99 per sim phase (over the last
+//   PROF_RING_SIZE samples) and --csv / --trace dump those samples.
+//   --replay plays a recording back at full speed and checks it ends on the same
+//   tick, score and state hash (exit code 1 if not), e.g. to prove an optimization
+//   didn't change gameplay.
+//   --rewind N snapshots the run at tick N, plays on to the end, then restores the
+//   snapshot and plays the rest again: both ends have to hash the same (exit code 1
+//   if not). Also prints what a snapshot and a restore cost.
+//   --input-test S runs S seconds in real time at 60 frames/s with a synthetic mouse
+//   (a fast circling crosshair and taps of 6..27 ms every 97 ms) sampled at --input-hz
+//   (1000) on an input thread, and compares the queued ticks (src/input.c) with
+//   sampling once per frame: taps missed, how far the shot's tick is from the click and
+//   how far its aim is from where the click was. exit code 1 if the queue missed a tap.
+//   --alloc-check N treats the first N ticks as warm-up and fails (exit code 1) if any
+//   tick after that allocates, naming the tick and which subsystems (src/mem.h) did it.
+//   every run ends with what each subsystem holds, its peak and its allocation count.
+//   --telemetry writes the run's gameplay log (src/telemetry.h), `bin/telsum` reads it.
+//   --coop plays one side of a two-process co-op game (src/net.c) in real time at 60
+//   frames/s: the bot drives player 0 or 1, the other process the other one, over UDP
+//   on 127.0.0.1. --lag/--jitter/--loss fake a worse network on what this side sends.
+//   Runs --ticks ticks (default 1800), then prints rollback counts and the final hash,
+//   which has to match the other side's (`make coop-check`). exit code 1 on a desync or
+//   if the peer never showed up.
+
+#define _POSIX_C_SOURCE 200112L
+#include "sim.h"
+#include "input.h"
+#include "replay.h"
+#include "bot.h"
+#include "jobs.h"
+#include "mem.h"
+#include "prof.h"
+#include "snapshot.h"
+#include "net.h"
+#include "telemetry.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double NowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void PrintTiming(long ticks, int hz, double secs) {
+    printf("ticks      %ld (%d Hz, %.1f sim-seconds)\n", ticks, hz, ticks / (double)hz);
+    printf("wall       %.3f s\n", secs);
+    printf("ticks/sec  %.0f\n", ticks / secs);
+    printf("ns/tick    %.1f\n", secs * 1e9 / ticks);
+}
+
+static void PrintPool(const char *name, const EntityPool *p) {
+    printf("%-10s capacity %d, high water %d, %d chunk allocs, %d dropped\n",
+           name, p->capacity, p->highWater, p->grows, p->dropped);
+}
+
+static void PrintMemory(void) {
+    for (int t = 0; t < MEM_TAG_COUNT; ++t) {
+        MemStats st = MemGetTagStats((MemTag)t);
+        if (st.peakBytes == 0 && st.allocs == 0) continue;
+        printf("%-10s %-10s %10.1f KB now, %10.1f KB peak, %6llu allocs\n", "memory", MemTagName((MemTag)t),
+               st.bytes / 1024.0, st.peakBytes / 1024.0, (unsigned long long)st.allocs);
+    }
+}
+
+// the subsystems that allocated between two counts, "pools +2, collision +1"
+static void PrintAllocs(long tick, const MemCounts *before, const MemCounts *after) {
+    printf("alloc      tick %ld:", tick);
+    const char *sep = " ";
+    for (int t = 0; t < MEM_TAG_COUNT; ++t) {
+        if (after->allocs[t] == before->allocs[t]) continue;
+        printf("%s%s +%llu", sep, MemTagName((MemTag)t), (unsigned long long)(after->allocs[t] - before->allocs[t]));
+        sep = ", ";
+    }
+    printf("\n");
+}
+
+static void PrintProfile(void) {
+    if (!PROF_ENABLED) return;
+    ProfStats st[PROF_PHASE_COUNT];
+    ProfSummarize(st);
+    printf("%-16s %8s %10s %10s %10s\n", "phase", "samples", "p50_us", "p99_us", "max_us");
+    for (int p = 0; p < PROF_PHASE_COUNT; ++p) {
+        if (st[p].count == 0) continue;
+        printf("%-16s %8d %10.2f %10.2f %10.2f\n", ProfPhaseName((ProfPhase)p),
+               st[p].count, st[p].p50, st[p].p99, st[p].max);
+    }
+}
+
+static int RunReplay(const char *path) {
+    Replay rp;
+    if (!ReplayLoad(&rp, path)) {
+        fprintf(stderr, "headless: can't read replay %s\n", path);
+        return 1;
+    }
+
+    static GameState game;
+    if (!SimInit(&game, rp.highScore, rp.seed)) {
+        fprintf(stderr, "headless: out of memory\n");
+        ReplayFree(&rp);
+        return 1;
+    }
+
+    float step = 1.0f / (float)rp.hz;    // same as SimClock
+    SimInput in;
+    long ticks = 0;
+    double t0 = NowSeconds();
+    while (ReplayNext(&rp, &in)) {
+        SimStep(&game, &in, step);
+        ticks++;
+    }
+    double secs = NowSeconds() - t0;
+
+    uint64_t hash = SimHash(&game);
+    bool ok = ticks == (long)rp.ticks && game.score == rp.finalScore && hash == rp.finalHash;
+    PrintTiming(ticks, rp.hz, secs);
+    printf("score      %d (recorded %d)\n", game.score, rp.finalScore);
+    printf("hash       %016llx (recorded %016llx)\n", (unsigned long long)hash, (unsigned long long)rp.finalHash);
+    printf("replay     %s\n", ok ? "MATCH" : "MISMATCH");
+
+    SimFree(&game);
+    ReplayFree(&rp);
+    return ok ? 0 : 1;
+}
+
+// ---- --input-test ----
+
+#define SYNTH_TAP_EVERY 97000000ull      // ns
+#define SYNTH_TAP_AT    5000000ull       // into each period
+#define SYNTH_MAX_TAPS  4096
+
+// where the synthetic mouse is at t: circling the middle at 2 turns a second
+// (~2500 px/s), fire held during tap k for 6..27 ms
+static void SynthAt(uint64_t t0, uint64_t t, InputSample *out) {
+    uint64_t dt = t > t0 ? t - t0 : 0;
+    double a = (double)dt * 1e-9 * 2.0 * 2.0 * SIM_PI;
+    uint64_t k = dt / SYNTH_TAP_EVERY, in = dt % SYNTH_TAP_EVERY;
+    uint64_t len = (6 + (k * 7) % 22) * 1000000ull;
+    out->t = t;
+    out->aim = ReplaySnapAim((Vec2){ SCREEN_W / 2 + 200.0f * (float)cos(a), SCREEN_H / 2 + 200.0f * (float)sin(a) });
+    out->fire = in >= SYNTH_TAP_AT && in < SYNTH_TAP_AT + len;
+    out->restart = false;
+}
+
+static bool SynthPoll(void *user, InputSample *out) {
+    SynthAt(*(const uint64_t *)user, out->t, out);
+    return true;                              // the aim never sits still
+}
+
+typedef struct {
+    int seen;
+    double timing, timingMax, aim, aimMax;    // ms, px
+    bool credited[SYNTH_MAX_TAPS];
+} TapStats;
+
+// a shot seen in a sample taken at `seen`, fired on a tick ending at `at` and aimed at
+// `aim`: charge it to the tap it belongs to
+static void CreditTap(TapStats *st, uint64_t t0, uint64_t seen, uint64_t at, Vec2 aim, long taps) {
+    if (seen < t0 + SYNTH_TAP_AT) return;
+    long k = (long)((seen - t0 - SYNTH_TAP_AT) / SYNTH_TAP_EVERY);
+    if (k >= taps || k >= SYNTH_MAX_TAPS || st->credited[k]) return;
+    InputSample truth;
+    uint64_t press = t0 + (uint64_t)k * SYNTH_TAP_EVERY + SYNTH_TAP_AT;
+    SynthAt(t0, press, &truth);
+    double ms = fabs((double)((int64_t)(at - press))) * 1e-6;
+    double px = hypot(aim.x - truth.aim.x, aim.y - truth.aim.y);
+    st->credited[k] = true;
+    st->seen++;
+    st->timing += ms; st->aim += px;
+    if (ms > st->timingMax) st->timingMax = ms;
+    if (px > st->aimMax) st->aimMax = px;
+}
+
+typedef struct {
+    InputReader reader;
+    uint64_t t0;
+    long taps;
+    bool lastFire;
+    TapStats queued;
+} QueuedTicks;
+
+static void QueuedNext(void *user, float behind, SimInput *out) {
+    QueuedTicks *q = user;
+    InputReaderNext(&q->reader, behind, out);
+    if (out->fire && !q->lastFire) {
+        uint64_t at = q->reader.now - (uint64_t)(behind * 1e9f);
+        CreditTap(&q->queued, q->t0, at, at, out->aim, q->taps);
+    }
+    q->lastFire = out->fire;
+}
+
+static void PrintTaps(const char *name, const TapStats *st, long taps) {
+    int n = st->seen > 0 ? st->seen : 1;
+    printf("%-10s %6d %7ld %14.2f %14.2f %11.1f %11.1f\n", name, st->seen, taps - st->seen,
+           st->timing / n, st->timingMax, st->aim / n, st->aimMax);
+}
+
+static int RunInputTest(double seconds, int inputHz, uint64_t seed) {
+    static GameState game;
+    static InputQueue queue;
+    static QueuedTicks q;
+    static TapStats frame;
+    if (!SimInit(&game, 0, seed)) {
+        fprintf(stderr, "headless: out of memory\n");
+        return 1;
+    }
+    InputQueueInit(&queue);
+    InputReaderInit(&q.reader, &queue);
+    SimClock clock;
+    SimClockInit(&clock, SIM_TICK_HZ);
+
+    uint64_t t0 = InputNow();
+    uint64_t end = t0 + (uint64_t)(seconds * 1e9);
+    q.t0 = t0;
+    q.taps = (long)((end - t0 - SYNTH_TAP_AT) / SYNTH_TAP_EVERY);
+    InputThread thread;
+    if (!InputThreadStart(&thread, &queue, inputHz, SynthPoll, &q.t0)) {
+        fprintf(stderr, "headless: can't start the input thread\n");
+        return 1;
+    }
+
+    // 60 Hz frames on absolute deadlines, like vsync
+    const uint64_t framePeriod = 1000000000ull / 60;
+    uint64_t last = t0, next = t0 + framePeriod;
+    bool frameFire = false;
+    long frames = 0;
+    while (next < end) {
+        struct timespec ts = { (time_t)(next / 1000000000ull), (long)(next % 1000000000ull) };
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        uint64_t now = InputNow();
+
+        // what IsMouseButtonDown / GetMousePosition would have said this frame:
+        // that input goes to every tick of the frame, the first one fires
+        InputSample polled;
+        SynthAt(t0, now, &polled);
+        float behindFirst = clock.acc + (float)((now - last) * 1e-9) - clock.step;
+        if (behindFirst >= 0.0f) {
+            if (polled.fire && !frameFire) CreditTap(&frame, t0, now, now - (uint64_t)(behindFirst * 1e9f), polled.aim, q.taps);
+            frameFire = polled.fire;
+        }
+
+        q.reader.now = now;
+        SimAdvanceEach(&game, &clock, QueuedNext, &q, (float)((now - last) * 1e-9));
+        last = now;
+        next += framePeriod;
+        frames++;
+    }
+    InputThreadStop(&thread);
+
+    printf("input      %.1f s, %ld frames at 60 Hz, %d Hz ticks, %d Hz input thread\n",
+           seconds, frames, clock.hz, inputHz);
+    printf("samples    %llu polled, %llu taken, %u dropped\n", (unsigned long long)thread.polls,
+           (unsigned long long)q.reader.taken, queue.dropped);
+    printf("%-10s %6s %7s %14s %14s %11s %11s\n", "policy", "taps", "missed", "timing_ms_avg", "timing_ms_max",
+           "aim_px_avg", "aim_px_max");
+    PrintTaps("frame", &frame, q.taps);
+    PrintTaps("queued", &q.queued, q.taps);
+    SimFree(&game);
+    return q.queued.seen == q.taps && queue.dropped == 0 ? 0 : 1;
+}
+
+// ---- --coop ----
+
+typedef struct {
+    int self, port, peerPort, delay;
+    int lagMs, jitterMs, lossPct;
+} CoopArgs;
+
+static int RunCoop(const CoopArgs *a, long ticks, uint64_t seed) {
+    static GameState game;
+    static NetLink link;
+    static NetSession ns;
+    if (!SimInit(&game, 0, seed)) {
+        fprintf(stderr, "headless: out of memory\n");
+        return 1;
+    }
+    SimSetPlayers(&game, 2);
+    if (!NetLinkOpen(&link, (uint16_t)a->port, (uint16_t)a->peerPort)) {
+        fprintf(stderr, "headless: can't bind 127.0.0.1:%d\n", a->port);
+        return 1;
+    }
+    link.lagMs = a->lagMs;
+    link.jitterMs = a->jitterMs;
+    link.lossPct = a->lossPct;
+    if (!NetSessionInit(&ns, &game, &link, a->self, a->delay, SIM_TICK_HZ)) {
+        fprintf(stderr, "headless: out of memory\n");
+        return 1;
+    }
+    ns.maxTick = (uint32_t)ticks;
+
+    // 60 Hz frames on absolute deadlines, like vsync. 10 s to find the peer, then
+    // after the last tick up to 2 s more sending until it has all our inputs
+    const uint64_t framePeriod = 1000000000ull / 60;
+    uint64_t t0 = InputNow(), last = t0, next = t0 + framePeriod, started = 0, done = 0;
+    double worst = 0.0;
+    long frames = 0, games = 0, bestScore = 0;
+    for (;;) {
+        struct timespec ts = { (time_t)(next / 1000000000ull), (long)(next % 1000000000ull) };
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        uint64_t now = InputNow();
+
+        SimInput in = BotInput(&game, a->self);
+        double w0 = NowSeconds();
+        NetAdvance(&ns, &in, started ? (float)((now - last) * 1e-9) : 0.0f);
+        double w = NowSeconds() - w0;
+        if (w > worst) worst = w;
+        if (ns.overFinal) {
+            games++;
+            if (ns.overScore > bestScore) bestScore = ns.overScore;
+        }
+        if (!started && ns.heard) started = now;
+        last = now;
+        next += framePeriod;
+        frames++;
+
+        if (!started && now - t0 > 10000000000ull) break;
+        if (!done && NetSettled(&ns, ns.maxTick)) done = now;
+        if (done && (ns.peerAck >= ns.maxTick || now - done > 2000000000ull)) break;
+    }
+
+    int rc = 0;
+    if (!done) {
+        fprintf(stderr, "headless: %s\n", started ? "co-op never finished" : "no peer on 127.0.0.1");
+        rc = 1;
+    }
+    printf("coop       player %d, %u ticks in %ld frames, delay %d, lag %d+%d ms, loss %d%%\n",
+           a->self, ns.tick, frames, ns.delay, a->lagMs, a->jitterMs, a->lossPct);
+    printf("packets    %u sent, %u received, %u lost, %u bad\n", link.sent, link.received, link.lost, link.bad);
+    printf("rollback   %u rollbacks, %u ticks re-simulated, longest %u, %u predicted, %u stalls\n",
+           ns.rollbacks, ns.resimTicks, ns.maxRollback, ns.predictedTicks, ns.stalls);
+    printf("frame      worst %.2f ms of sim + net\n", worst * 1e3);
+    printf("checks     %u hash checks, %u desyncs\n", ns.hashChecks, ns.desyncs);
+    printf("games      %ld confirmed over (best score %ld)\n", games, bestScore);
+    printf("hash       %016llx\n", (unsigned long long)SimHash(&game));
+    if (ns.desyncs) rc = 1;
+    PrintProfile();
+
+    NetSessionFree(&ns);
+    NetLinkClose(&link);
+    SimFree(&game);
+    return rc;
+}
+
+int main(int argc, char **argv) {
+    long ticks = -1;
+    int hz = SIM_TICK_HZ;
+    uint64_t seed = 1234;
+    const char *recordPath = NULL, *csvPath = NULL, *tracePath = NULL, *telemetryPath = NULL;
+    int threads = 1;
+    long rewindAt = -1, allocWarmup = -1;
+    double inputTest = 0.0;
+    int inputHz = 1000;
+    CoopArgs coop = { -1, 0, 0, 2, 0, 0, 0 };
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!val) { fprintf(stderr, "headless: %s needs a value\n", arg); return 1; }
+        if      (strcmp(arg, "--ticks") == 0)  ticks = atol(val);
+        else if (strcmp(arg, "--hz") == 0)     hz = atoi(val);
+        else if (strcmp(arg, "--seed") == 0)   seed = strtoull(val, NULL, 10);
+        else if (strcmp(arg, "--record") == 0) recordPath = val;
+        else if (strcmp(arg, "--threads") == 0) threads = atoi(val);
+        else if (strcmp(arg, "--csv") == 0)     csvPath = val;
+        else if (strcmp(arg, "--trace") == 0)   tracePath = val;
+        else if (strcmp(arg, "--rewind") == 0)  rewindAt = atol(val);
+        else if (strcmp(arg, "--telemetry") == 0) telemetryPath = val;
+        else if (strcmp(arg, "--alloc-check") == 0) allocWarmup = atol(val);
+        else if (strcmp(arg, "--input-hz") == 0) inputHz = atoi(val);
+        else if (strcmp(arg, "--input-test") == 0) inputTest = atof(val);
+        else if (strcmp(arg, "--coop") == 0)      coop.self = atoi(val);
+        else if (strcmp(arg, "--port") == 0)      coop.port = atoi(val);
+        else if (strcmp(arg, "--peer-port") == 0) coop.peerPort = atoi(val);
+        else if (strcmp(arg, "--delay") == 0)     coop.delay = atoi(val);
+        else if (strcmp(arg, "--lag") == 0)       coop.lagMs = atoi(val);
+        else if (strcmp(arg, "--jitter") == 0)    coop.jitterMs = atoi(val);
+        else if (strcmp(arg, "--loss") == 0)      coop.lossPct = atoi(val);
+        else if (strcmp(arg, "--replay") == 0) return RunReplay(val);
+        else { fprintf(stderr, "headless: unknown option %s\n", arg); return 1; }
+        i++;
+    }
+    if (ticks < 0) ticks = coop.self >= 0 ? 1800 : 1000000;
+    bool coopOk = coop.self < 0 || (coop.self <= 1 && coop.port > 0 && coop.peerPort > 0 && coop.port < 65536 &&
+                                    coop.peerPort < 65536 && coop.delay >= 0 && coop.delay <= NET_MAX_DELAY);
+    if (ticks <= 0 || hz <= 0 || rewindAt >= ticks || inputHz <= 0 || !coopOk) {
+        fprintf(stderr, "usage: %s [--ticks N] [--hz N] [--seed N] [--threads N] [--record f] [--csv f] [--trace f] [--rewind N] [--telemetry f] [--alloc-check N]\n"
+                        "       %s --replay f | --input-test seconds [--input-hz N]\n"
+                        "       %s --coop 0|1 --port P --peer-port Q [--ticks N] [--delay 0..%d] [--lag ms] [--jitter ms] [--loss pct]\n",
+                argv[0], argv[0], argv[0], NET_MAX_DELAY);
+        return 1;
+    }
+    if (inputTest > 0.0) return RunInputTest(inputTest, inputHz, seed);
+    if (coop.self >= 0) return RunCoop(&coop, ticks, seed);
+
+    static GameState game;
+    if (!SimInit(&game, 0, seed)) {
+        fprintf(stderr, "headless: out of memory\n");
+        return 1;
+    }
+
+    static JobSystem jobs;
+    if (threads > 1) {
+        if (!JobsInit(&jobs, threads)) {
+            fprintf(stderr, "headless: can't start %d threads\n", threads);
+            return 1;
+        }
+        game.jobs = &jobs;
+    }
+
+    ReplayWriter rec = {0};
+    if (recordPath && !ReplayWriterOpen(&rec, recordPath, seed, hz, game.highScore)) {
+        fprintf(stderr, "headless: can't write %s\n", recordPath);
+        return 1;
+    }
+
+    static Telemetry telemetry;
+    if (telemetryPath) {
+        if (!TelemetryOpen(&telemetry, telemetryPath, seed, hz, game.tick)) {
+            fprintf(stderr, "headless: can't write %s\n", telemetryPath);
+            return 1;
+        }
+        game.telemetry = &telemetry;
+    }
+
+    float step = 1.0f / (float)hz;
+    long games = 1, bestScore = 0;
+    Snapshot snap = {0};
+    double saveSecs = 0.0;
+    long allocTicks = 0;
+    double t0 = NowSeconds();
+    for (long t = 0; t < ticks; ++t) {
+        if (t == rewindAt) {
+            double s0 = NowSeconds();
+            if (!SnapshotSave(&snap, &game)) { fprintf(stderr, "headless: out of memory\n"); return 1; }
+            saveSecs = NowSeconds() - s0;
+        }
+        SimInput in = BotInput(&game, 0);
+        if (recordPath) ReplayWriterTick(&rec, &in);
+        if (allocWarmup >= 0 && t >= allocWarmup) {
+            MemCounts before = MemGetCounts();
+            SimStep(&game, &in, step);
+            MemCounts after = MemGetCounts();
+            if (memcmp(&before, &after, sizeof(before)) != 0 && allocTicks++ < 10) PrintAllocs(t, &before, &after);
+        } else {
+            SimStep(&game, &in, step);
+        }
+        if (game.events & SIM_EVENT_GAME_OVER && game.score > bestScore) bestScore = game.score;
+        if (game.events & SIM_EVENT_RESTART) games++;
+    }
+    if (game.telemetry) {
+        game.telemetry = NULL;    // the rewind below would log the same ticks again
+        TelemetryClose(&telemetry);
+    }
+    double secs = NowSeconds() - t0;
+
+    PrintTiming(ticks, hz, secs);
+    printf("games      %ld (best score %ld, high score %d)\n", games, bestScore, game.highScore);
+    printf("hash       %016llx\n", (unsigned long long)SimHash(&game));
+    int rc = 0;
+    if (rewindAt >= 0) {
+        // the bot only looks at the state, so the same state gives the same inputs
+        uint64_t want = SimHash(&game);
+        double r0 = NowSeconds();
+        bool restored = SnapshotRestore(&snap, &game);
+        double restoreSecs = NowSeconds() - r0;
+        for (long t = rewindAt; restored && t < ticks; ++t) {
+            SimInput in = BotInput(&game, 0);
+            SimStep(&game, &in, step);
+        }
+        bool ok = restored && SimHash(&game) == want;
+        printf("rewind     tick %ld, %zu bytes, save %.1f us, restore %.1f us: %s\n", rewindAt, snap.size,
+               saveSecs * 1e6, restoreSecs * 1e6, ok ? "MATCH" : "MISMATCH");
+        if (!ok) rc = 1;
+        SnapshotFree(&snap);
+    }
+    PrintPool("enemies", &game.enemies);
+    PrintPool("bullets", &game.bullets);
+    PrintMemory();
+    if (allocWarmup >= 0) {
+        long checked = ticks > allocWarmup ? ticks - allocWarmup : 0;
+        printf("alloc      %ld ticks checked after %ld of warm-up, %ld allocated: %s\n", checked, allocWarmup, allocTicks,
+               allocTicks ? "FAIL" : "ok");
+        if (allocTicks) rc = 1;
+    }
+    if (telemetryPath) {
+        printf("telemetry  %llu records, %llu bytes (%.2f per tick), %u flushes, %u dropped%s\n",
+               (unsigned long long)telemetry.records, (unsigned long long)telemetry.bytes,
+               (double)telemetry.bytes / ticks, telemetry.flushes, telemetry.dropped,
+               telemetry.writeFailures ? ", WRITE FAILED" : "");
+        if (telemetry.writeFailures) rc = 1;
+    }
+    PrintProfile();
+    if (csvPath && !ProfWriteCsv(csvPath)) fprintf(stderr, "headless: can't write %s\n", csvPath);
+    if (tracePath && !ProfWriteChromeTrace(tracePath)) fprintf(stderr, "headless: can't write %s\n", tracePath);
+    if (recordPath && !ReplayWriterClose(&rec, &game)) {
+        fprintf(stderr, "headless: failed writing %s\n", recordPath);
+        return 1;
+    }
+    SimFree(&game);
+    if (game.jobs) JobsShutdown(&jobs);
+    return rc;
+}
@@ -0,0 +1,302 @@
+// NULL TERMINATOR — balance sweeps
+// Plays whole games with the bot (src/bot.c), spread over every core, for each point
+// of a grid of tuning values, and prints how long the bot survived and what it scored.
+//
+// usage: bin/sweep [--games N] [--threads N] [--seed N] [--max-time S] [--csv out.csv] [--list]
+//                  [KNOB=v1,v2,... | KNOB=lo:hi:step]...
+//   KNOB is a define name from tuning.h's SIM_TUNING_FIELDS (--list shows them with
+//   their defaults). Every combination of the given values is one grid point. Each
+//   point plays --games games (default 200) on seeds seed, seed+1, ..., so all points
+//   face the same runs. A game ends at game over, or after --max-time sim seconds
+//   (default 600) when it counts as capped.
+//   Games are independent and results land in per-game slots, so the output doesn't
+//   depend on --threads (default: one per core).
+//
+//   e.g. bin/sweep SPAWN_RAMP=0.01:0.02:0.005 SHOTGUN_UNLOCK_AFTER_SCORE=250,500,1000
+
+#define _POSIX_C_SOURCE 199309L
+#include "sim.h"
+#include "bot.h"
+#include "jobs.h"
+#include "mem.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_AXES   8
+#define MAX_VALUES 64
+#define MAX_POINTS 100000
+
+typedef struct {
+    const char *name;
+    double values[MAX_VALUES];
+    int count;
+} Axis;
+
+typedef struct {
+    float survival;          // sim seconds
+    int score;
+    int ticks;
+    bool capped;             // still alive at --max-time
+    bool shotgun;            // unlocked it before dying
+} GameResult;
+
+typedef struct {
+    const Axis *axes;
+    int axisCount;
+    int games;
+    uint64_t seed;
+    long maxTicks;
+    GameResult *results;     // point * games + game
+} Sweep;
+
+static double NowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// value of every axis at grid point p (last axis varies fastest)
+static void PointTuning(const Sweep *sw, int p, SimTuning *t) {
+    SimTuningDefaults(t);
+    for (int a = sw->axisCount - 1; a >= 0; --a) {
+        const Axis *ax = &sw->axes[a];
+        SimTuningSet(t, ax->name, ax->values[p % ax->count]);
+        p /= ax->count;
+    }
+}
+
+// fresh run on g's memory, same start as SimInit with this seed
+static GameResult PlayGame(GameState *g, const SimTuning *tune, uint64_t seed, long maxTicks) {
+    SimRestart(g, seed);
+    g->tune = *tune;
+
+    const float step = 1.0f / SIM_TICK_HZ;
+    long t = 0;
+    while (t < maxTicks && g->state == STATE_PLAYING) {
+        SimInput in = BotInput(g, 0);
+        SimStep(g, &in, step);
+        t++;
+    }
+    return (GameResult){ g->timeSinceStart, g->score, (int)t, g->state == STATE_PLAYING, g->weapon != SIM_WEAPON_PISTOL };
+}
+
+// a range of games, on a GameState of its own (pools keep their memory between games)
+static void PlayJob(void *user, int begin, int end) {
+    Sweep *sw = user;
+    GameState *g = MemAlloc(MEM_OTHER, sizeof(*g));
+    if (!g || !SimInit(g, 0, 0)) {
+        fprintf(stderr, "sweep: out of memory, games %d..%d not played\n", begin, end - 1);
+        MemFree(g);
+        return;
+    }
+    SimTuning tune;
+    int point = -1;
+    for (int i = begin; i < end; ++i) {
+        int p = i / sw->games;
+        if (p != point) { PointTuning(sw, p, &tune); point = p; }
+        sw->results[i] = PlayGame(g, &tune, sw->seed + (uint64_t)(i % sw->games), sw->maxTicks);
+    }
+    SimFree(g);
+    MemFree(g);
+}
+
+static int CompareFloat(const void *a, const void *b) {
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+// nearest-rank percentile of a sorted array
+static float Percentile(const float *sorted, int n, int pct) {
+    int i = (pct * n + 99) / 100 - 1;
+    return sorted[i < 0 ? 0 : i];
+}
+
+typedef struct {
+    float mean, p[5], max;   // p10 p25 p50 p75 p90
+} Dist;
+
+static const int distPct[5] = { 10, 25, 50, 75, 90 };
+
+static Dist Distribution(float *v, int n) {
+    Dist d = {0};
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i) sum += v[i];
+    qsort(v, (size_t)n, sizeof(float), CompareFloat);
+    d.mean = (float)(sum / n);
+    for (int k = 0; k < 5; ++k) d.p[k] = Percentile(v, n, distPct[k]);
+    d.max = v[n - 1];
+    return d;
+}
+
+static bool ParseAxis(Axis *ax, char *arg) {
+    char *eq = strchr(arg, '=');
+    if (!eq) return false;
+    *eq = '\0';
+    ax->name = arg;
+    ax->count = 0;
+    SimTuning probe;
+    double dummy;
+    SimTuningDefaults(&probe);
+    if (!SimTuningGet(&probe, ax->name, &dummy)) {
+        fprintf(stderr, "sweep: no tuning knob called %s (try --list)\n", ax->name);
+        return false;
+    }
+
+    const char *spec = eq + 1;
+    double lo, hi, step;
+    if (sscanf(spec, "%lf:%lf:%lf", &lo, &hi, &step) == 3) {
+        if (step <= 0.0 || hi < lo) return false;
+        for (int k = 0; ax->count < MAX_VALUES; ++k) {
+            double v = lo + step * k;      // no accumulated error
+            if (v > hi + step * 1e-6) break;
+            ax->values[ax->count++] = v;
+        }
+        return ax->count > 0;
+    }
+    for (char *tok = strtok(eq + 1, ","); tok && ax->count < MAX_VALUES; tok = strtok(NULL, ",")) {
+        char *endp;
+        ax->values[ax->count++] = strtod(tok, &endp);
+        if (endp == tok || *endp != '\0') return false;
+    }
+    return ax->count > 0;
+}
+
+static void PrintKnobs(void) {
+    SimTuning t;
+    SimTuningDefaults(&t);
+#define PRINT_KNOB(type, field, def) printf("%-28s %g\n", #def, (double)t.field);
+    SIM_TUNING_FIELDS(PRINT_KNOB)
+#undef PRINT_KNOB
+}
+
+int main(int argc, char **argv) {
+    int games = 200, threads = JobsCpuCount();
+    uint64_t seed = 1;
+    float maxTime = 600.0f;
+    const char *csvPath = NULL;
+    Axis axes[MAX_AXES];
+    int axisCount = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--list") == 0) { PrintKnobs(); return 0; }
+        if (arg[0] != '-') {
+            if (axisCount == MAX_AXES || !ParseAxis(&axes[axisCount], argv[i])) {
+                fprintf(stderr, "sweep: bad grid axis %s (KNOB=a,b,c or KNOB=lo:hi:step, up to %d axes)\n", arg, MAX_AXES);
+                return 1;
+            }
+            axisCount++;
+            continue;
+        }
+        if (!val) { fprintf(stderr, "sweep: %s needs a value\n", arg); return 1; }
+        if      (strcmp(arg, "--games") == 0)    games = atoi(val);
+        else if (strcmp(arg, "--threads") == 0)  threads = atoi(val);
+        else if (strcmp(arg, "--seed") == 0)     seed = strtoull(val, NULL, 10);
+        else if (strcmp(arg, "--max-time") == 0) maxTime = (float)atof(val);
+        else if (strcmp(arg, "--csv") == 0)      csvPath = val;
+        else { fprintf(stderr, "sweep: unknown option %s\n", arg); return 1; }
+        i++;
+    }
+
+    long points = 1;
+    for (int a = 0; a < axisCount; ++a) points *= axes[a].count;
+    if (games <= 0 || maxTime <= 0.0f || points > MAX_POINTS || points * games > 0x7FFFFFFF) {
+        fprintf(stderr, "usage: %s [--games N] [--threads N] [--seed N] [--max-time S] [--csv f] [--list] [KNOB=values]...\n", argv[0]);
+        return 1;
+    }
+
+    Sweep sw = { axes, axisCount, games, seed, (long)(maxTime * SIM_TICK_HZ), NULL };
+    int total = (int)(points * games);
+    sw.results = MemAlloc(MEM_OTHER, sizeof(GameResult) * (size_t)total);
+    float *scratch = MemAlloc(MEM_OTHER, sizeof(float) * (size_t)games);
+    if (!sw.results || !scratch) {
+        fprintf(stderr, "sweep: out of memory\n");
+        return 1;
+    }
+
+    static JobSystem jobs;
+    JobSystem *js = NULL;
+    if (threads > 1) {
+        if (!JobsInit(&jobs, threads)) {
+            fprintf(stderr, "sweep: can't start %d threads\n", threads);
+            return 1;
+        }
+        js = &jobs;
+    }
+    int cores = js ? js->threadCount : 1;
+
+    // a few games per task: enough to amortize SimInit, small enough to steal
+    double t0 = NowSeconds();
+    JobsParallelFor(js, total, 4, PlayJob, &sw);
+    double secs = NowSeconds() - t0;
+    if (js) JobsShutdown(js);
+
+    FILE *csv = NULL;
+    if (csvPath) {
+        csv = fopen(csvPath, "w");
+        if (!csv) {
+            fprintf(stderr, "sweep: can't write %s\n", csvPath);
+            return 1;
+        }
+        for (int a = 0; a < axisCount; ++a) fprintf(csv, "%s,", axes[a].name);
+        fprintf(csv, "games,capped,shotgun_rate");
+        for (int q = 0; q < 2; ++q) {
+            const char *what = q ? "score" : "survival";
+            fprintf(csv, ",%s_mean", what);
+            for (int k = 0; k < 5; ++k) fprintf(csv, ",%s_p%d", what, distPct[k]);
+            fprintf(csv, ",%s_max", what);
+        }
+        fprintf(csv, "\n");
+    }
+
+    for (int a = 0; a < axisCount; ++a) printf("%-12.12s ", axes[a].name);
+    printf("%8s %8s %8s %8s %8s %8s %8s %8s %7s %8s\n", "surv_avg", "surv_p10", "surv_p50", "surv_p90",
+           "score_avg", "scr_p10", "scr_p50", "scr_p90", "capped", "shotgun");
+
+    long long ticks = 0;
+    for (int p = 0; p < points; ++p) {
+        const GameResult *r = &sw.results[(size_t)p * games];
+        int capped = 0, shotgun = 0;
+        for (int i = 0; i < games; ++i) {
+            scratch[i] = r[i].survival;
+            capped += r[i].capped;
+            shotgun += r[i].shotgun;
+            ticks += r[i].ticks;
+        }
+        Dist surv = Distribution(scratch, games);
+        for (int i = 0; i < games; ++i) scratch[i] = (float)r[i].score;
+        Dist score = Distribution(scratch, games);
+
+        SimTuning t;
+        PointTuning(&sw, p, &t);
+        for (int a = 0; a < axisCount; ++a) {
+            double v;
+            SimTuningGet(&t, axes[a].name, &v);
+            printf("%-12g ", v);
+            if (csv) fprintf(csv, "%g,", v);
+        }
+        printf("%8.1f %8.1f %8.1f %8.1f %8.0f %8.0f %8.0f %8.0f %7d %7.0f%%\n", surv.mean, surv.p[0], surv.p[2], surv.p[4],
+               score.mean, score.p[0], score.p[2], score.p[4], capped, 100.0 * shotgun / games);
+        if (csv) {
+            fprintf(csv, "%d,%d,%.4f", games, capped, (double)shotgun / games);
+            const Dist *d[2] = { &surv, &score };
+            for (int q = 0; q < 2; ++q) {
+                fprintf(csv, ",%.3f", d[q]->mean);
+                for (int k = 0; k < 5; ++k) fprintf(csv, ",%.3f", d[q]->p[k]);
+                fprintf(csv, ",%.3f", d[q]->max);
+            }
+            fprintf(csv, "\n");
+        }
+    }
+    if (csv) fclose(csv);
+
+    printf("\n%d games (%ld points x %d) in %.2f s on %d threads: %.0f games/s, %.0f games/s/core, %.2fM ticks/s\n",
+           total, points, games, secs, cores, total / secs, total / secs / cores, ticks / secs * 1e-6);
+
+    MemFree(scratch);
+    MemFree(sw.results);
+    return 0;
+}
@@ -0,0 +1,216 @@
+// NULL TERMINATOR — telemetry summary
+// Reads a gameplay log (src/telemetry.h) written by the game or bin/headless
+// --telemetry and prints what happened in it: games and scores, kills and where they
+// happened, player hits, spawns, entity counts and frame times. Ticks a co-op rollback
+// simulated again count once, as they came out the second time.
+//
+// usage: bin/telsum log.ntt [--grid]
+//   --grid also prints kills per cell of an 8x6 grid over the playfield
+
+#include "telemetry.h"
+#include "tuning.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GRID_W 8
+#define GRID_H 6
+#define MAX_FRAMES (1 << 20)     // frame times kept for percentiles
+
+static unsigned char *ReadAll(const char *path, size_t *size) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    size_t cap = 1 << 16, n = 0;
+    unsigned char *data = malloc(cap);
+    size_t got;
+    while (data && (got = fread(data + n, 1, cap - n, f)) > 0) {
+        n += got;
+        if (n == cap) {
+            unsigned char *grown = realloc(data, cap * 2);
+            if (!grown) { free(data); data = NULL; break; }
+            data = grown;
+            cap *= 2;
+        }
+    }
+    fclose(f);
+    *size = n;
+    return data;
+}
+
+// every record in order, minus the ones a rewind superseded: back from the end to its
+// tick, all but the frame times (those frames really happened). NULL if out of memory
+static TelRecord *ReadRecords(TelReader *r, long *count, long *superseded) {
+    size_t cap = 1 << 12;
+    long n = 0;
+    TelRecord *recs = malloc(cap * sizeof(*recs));
+    TelRecord rec;
+    while (recs && TelReaderNext(r, &rec)) {
+        if (rec.kind == TEL_REWIND) {
+            long from = n;
+            while (from > 0 && (recs[from - 1].kind == TEL_FRAME || recs[from - 1].tick >= rec.tick)) from--;
+            long kept = from;
+            for (long i = from; i < n; ++i)
+                if (recs[i].kind == TEL_FRAME) recs[kept++] = recs[i];
+            *superseded += n - kept;
+            n = kept;
+        }
+        if ((size_t)n == cap) {
+            TelRecord *grown = realloc(recs, cap * 2 * sizeof(*recs));
+            if (!grown) { free(recs); recs = NULL; break; }
+            recs = grown;
+            cap *= 2;
+        }
+        recs[n++] = rec;
+    }
+    *count = n;
+    return recs;
+}
+
+static int CompareInt(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static double Pct(const int *sorted, int n, double p) {
+    if (n == 0) return 0.0;
+    int i = (int)(p * (n - 1) + 0.5);
+    return sorted[i];
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    bool grid = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--grid") == 0) grid = true;
+        else if (argv[i][0] != '-' && !path) path = argv[i];
+        else { path = NULL; break; }
+    }
+    if (!path) {
+        fprintf(stderr, "usage: %s log.ntt [--grid]\n", argv[0]);
+        return 1;
+    }
+
+    size_t size = 0;
+    unsigned char *data = ReadAll(path, &size);
+    TelReader r;
+    if (!data || !TelReaderInit(&r, data, size)) {
+        fprintf(stderr, "telsum: %s isn't a telemetry log (version %d)\n", path, TELEMETRY_VERSION);
+        free(data);
+        return 1;
+    }
+
+    uint32_t first = r.tick, last = r.tick;
+    long count = 0, superseded = 0;
+    TelRecord *recs = ReadRecords(&r, &count, &superseded);
+    if (!recs) {
+        fprintf(stderr, "telsum: out of memory\n");
+        free(data);
+        return 1;
+    }
+
+    long records = 0, kinds[TEL_KIND_COUNT] = {0};
+    long resimTicks = 0;
+    long spawned = 0, hurts = 0, grazes = 0, restarts = 0, unlocks = 0;
+    long games = 0, scoreSum = 0, scoreMax = 0, msSum = 0, msMax = 0;
+    long cells[GRID_H][GRID_W] = {{0}};
+    long headings[8] = {0};
+    int enemyMax = 0, bulletMax = 0;
+    double enemyTicks = 0.0, bulletTicks = 0.0;    // count x ticks it was held for
+    uint32_t countTick = r.tick;
+    int enemies = 0, bullets = 0;
+    static int frames[MAX_FRAMES];
+    int frameCount = 0, slowFrames = 0;
+    bool ended = false;
+
+    for (long i = 0; i < count; ++i) {
+        const TelRecord rec = recs[i];
+        records++;
+        kinds[rec.kind]++;
+        last = rec.tick;
+        switch (rec.kind) {
+        case TEL_TICK:
+            enemyTicks += (double)enemies * (rec.tick - countTick);
+            bulletTicks += (double)bullets * (rec.tick - countTick);
+            countTick = rec.tick;
+            enemies = rec.a; bullets = rec.b;
+            if (enemies > enemyMax) enemyMax = enemies;
+            if (bullets > bulletMax) bulletMax = bullets;
+            break;
+        case TEL_SPAWN:
+            spawned += rec.a;
+            break;
+        case TEL_KILL: {
+            int cx = rec.a * GRID_W / SCREEN_W, cy = rec.b * GRID_H / SCREEN_H;
+            if (cx >= 0 && cx < GRID_W && cy >= 0 && cy < GRID_H) cells[cy][cx]++;
+            headings[(rec.e + 16) / 32 % 8]++;
+            break;
+        }
+        case TEL_HIT:
+            if (rec.e) hurts++;
+            else grazes++;
+            break;
+        case TEL_UNLOCK:
+            unlocks++;
+            break;
+        case TEL_GAME_OVER:
+            games++;
+            scoreSum += rec.a; msSum += rec.b;
+            if (rec.a > scoreMax) scoreMax = rec.a;
+            if (rec.b > msMax) msMax = rec.b;
+            break;
+        case TEL_RESTART:
+            restarts++;
+            break;
+        case TEL_REWIND:
+            resimTicks += rec.a;
+            break;
+        case TEL_FRAME:
+            if (frameCount < MAX_FRAMES) frames[frameCount++] = rec.a;
+            if (rec.a > 1000000 / 60 + 1000) slowFrames++;
+            break;
+        case TEL_END:
+            ended = true;
+            break;
+        }
+    }
+    enemyTicks += (double)enemies * (last - countTick);
+    bulletTicks += (double)bullets * (last - countTick);
+
+    uint32_t span = last - first;
+    double secs = r.hz > 0 ? (double)span / r.hz : 0.0;
+    long kills = kinds[TEL_KILL];
+    printf("log        %s, %zu bytes, seed %llu, %d Hz%s\n", path, size, (unsigned long long)r.seed, r.hz,
+           ended ? "" : r.truncated ? ", TRUNCATED" : ", not closed");
+    printf("span       ticks %u..%u (%.1f sim-seconds), %ld records, %.2f bytes/tick\n", first, last, secs, records,
+           span ? (double)size / span : 0.0);
+    printf("games      %ld over, %ld restarts, %ld unlocks", games, restarts, unlocks);
+    if (games) printf(", score avg %.0f max %ld, survived avg %.1f s max %.1f s", (double)scoreSum / games, scoreMax,
+                      msSum * 1e-3 / games, msMax * 1e-3);
+    printf("\n");
+    if (kinds[TEL_REWIND])
+        printf("rollback   %ld rewinds, %ld ticks re-simulated, %ld records superseded\n", kinds[TEL_REWIND], resimTicks,
+               superseded);
+    printf("kills      %ld (%.1f/s), %ld spawned\n", kills, secs > 0 ? kills / secs : 0.0, spawned);
+    printf("headings   E %ld  SE %ld  S %ld  SW %ld  W %ld  NW %ld  N %ld  NE %ld   (bullet direction at the kill)\n",
+           headings[0], headings[1], headings[2], headings[3], headings[4], headings[5], headings[6], headings[7]);
+    printf("player     %ld hits, %ld more touches during i-frames\n", hurts, grazes);
+    printf("entities   enemies avg %.1f max %d, bullets avg %.1f max %d\n", span ? enemyTicks / span : 0.0, enemyMax,
+           span ? bulletTicks / span : 0.0, bulletMax);
+    if (frameCount) {
+        qsort(frames, (size_t)frameCount, sizeof(int), CompareInt);
+        printf("frames     %d, ms p50 %.2f p99 %.2f max %.2f, %d over 17.7 ms\n", frameCount, Pct(frames, frameCount, 0.5) * 1e-3,
+               Pct(frames, frameCount, 0.99) * 1e-3, frames[frameCount - 1] * 1e-3, slowFrames);
+    } else {
+        printf("frames     none (headless log)\n");
+    }
+    if (grid) {
+        printf("kills per cell (%dx%d px):\n", SCREEN_W / GRID_W, SCREEN_H / GRID_H);
+        for (int y = 0; y < GRID_H; ++y) {
+            for (int x = 0; x < GRID_W; ++x) printf(" %7ld", cells[y][x]);
+            printf("\n");
+        }
+    }
+    free(recs);
+    free(data);
+    return r.truncated ? 1 : 0;
+}